@@ -0,0 +1,191 @@
+// headless frustum culling benchmark
+// known answers first (planes of a perspective and an ortho camera, boxes
+// inside / outside / straddling), any miss fails the run before the timing.
+// then 1M random world boxes around a perspective camera, scalar test vs the
+// SSE2 batch test. both must report the same visible/culled counts.
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "flecs_culling.h"
+
+#define BENCH_COUNT 1000000
+#define BENCH_REPEAT 10
+#define CHECK_EPSILON 1e-4f              // relative, the far plane w is large
+
+static float bench_rand(float range){
+  return ((float)rand() / (float)RAND_MAX * 2.0f - 1.0f) * range;
+}
+
+static const char *planeNames[6] = { "left", "right", "bottom", "top", "near", "far" };
+
+static bool check_near(float got, float want){
+  return fabsf(got - want) <= CHECK_EPSILON * (1.0f + fabsf(want));
+}
+
+static int check_planes(const char *name, const Frustum3D *f, const Vector4 want[6]){
+  int failed = 0;
+  for (int p = 0; p < 6; p++) {
+    Vector4 got = f->planes[p];
+    if (!check_near(got.x, want[p].x) || !check_near(got.y, want[p].y) ||
+        !check_near(got.z, want[p].z) || !check_near(got.w, want[p].w)) {
+      printf("FAIL %s %s plane: got (%f %f %f %f) want (%f %f %f %f)\n", name, planeNames[p],
+        got.x, got.y, got.z, got.w, want[p].x, want[p].y, want[p].z, want[p].w);
+      failed++;
+    }
+  }
+  return failed;
+}
+
+typedef struct {
+  const char *name;
+  Vector3 center;
+  Vector3 extents;
+  bool isVisible;
+} CheckBox;
+
+// scalar and batch both, the batch runs 4 wide then the tail
+static int check_boxes(const Frustum3D *f, const CheckBox *boxes, int count){
+  int failed = 0;
+  Vector3 centers[16];
+  Vector3 extents[16];
+  bool visible[16];
+  for (int i = 0; i < count; i++) {
+    centers[i] = boxes[i].center;
+    extents[i] = boxes[i].extents;
+    bool got = culling_test_aabb(f, boxes[i].center, boxes[i].extents);
+    if (got != boxes[i].isVisible) {
+      printf("FAIL scalar %s: got %s\n", boxes[i].name, got ? "visible" : "culled");
+      failed++;
+    }
+  }
+  culling_test_aabb_batch(f, centers, sizeof(Vector3), extents, sizeof(Vector3), visible, sizeof(bool), count);
+  for (int i = 0; i < count; i++) {
+    if (visible[i] != boxes[i].isVisible) {
+      printf("FAIL batch %s: got %s\n", boxes[i].name, visible[i] ? "visible" : "culled");
+      failed++;
+    }
+  }
+  return failed;
+}
+
+// planes worked out by hand, camera on +z looking at the origin
+static int culling_known_answers(void){
+  int failed = 0;
+  const float h = 0.70710678f;
+
+  // 90 deg, square: the side planes are the 45 deg diagonals through the eye
+  Camera3D perspective = {
+    .position = (Vector3){ 0.0f, 0.0f, 10.0f },
+    .target = (Vector3){ 0.0f, 0.0f, 0.0f },
+    .up = (Vector3){ 0.0f, 1.0f, 0.0f },
+    .fovy = 90.0f,
+    .projection = CAMERA_PERSPECTIVE
+  };
+  Frustum3D pf = culling_frustum_from_camera(perspective, 1.0f, 1.0f, 100.0f);
+  const Vector4 perspectivePlanes[6] = {
+    { h, 0.0f, -h, 10.0f * h },       // x >= z - 10
+    { -h, 0.0f, -h, 10.0f * h },      // x <= 10 - z
+    { 0.0f, h, -h, 10.0f * h },
+    { 0.0f, -h, -h, 10.0f * h },
+    { 0.0f, 0.0f, -1.0f, 9.0f },      // z <= 9, 1 in front of the eye
+    { 0.0f, 0.0f, 1.0f, 90.0f }       // z >= -90, 100 in front of the eye
+  };
+  failed += check_planes("perspective", &pf, perspectivePlanes);
+
+  // ortho: fovy is the height, 10 x 20 box along the view axis
+  Camera3D ortho = perspective;
+  ortho.fovy = 10.0f;
+  ortho.projection = CAMERA_ORTHOGRAPHIC;
+  Frustum3D of = culling_frustum_from_camera(ortho, 2.0f, 1.0f, 50.0f);
+  const Vector4 orthoPlanes[6] = {
+    { 1.0f, 0.0f, 0.0f, 10.0f },
+    { -1.0f, 0.0f, 0.0f, 10.0f },
+    { 0.0f, 1.0f, 0.0f, 5.0f },
+    { 0.0f, -1.0f, 0.0f, 5.0f },
+    { 0.0f, 0.0f, -1.0f, 9.0f },
+    { 0.0f, 0.0f, 1.0f, 40.0f }
+  };
+  failed += check_planes("ortho", &of, orthoPlanes);
+
+  // at z = 0 the perspective frustum spans -10..10 in x and y
+  const Vector3 unit = { 1.0f, 1.0f, 1.0f };
+  const CheckBox perspectiveBoxes[] = {
+    { "inside", { 0.0f, 0.0f, 0.0f }, unit, true },
+    { "inside near the far plane", { 0.0f, 0.0f, -80.0f }, unit, true },
+    { "behind the eye", { 0.0f, 0.0f, 20.0f }, unit, false },
+    { "past the far plane", { 0.0f, 0.0f, -95.0f }, unit, false },
+    { "outside right", { 13.0f, 0.0f, 0.0f }, unit, false },
+    { "outside top", { 0.0f, 13.0f, 0.0f }, unit, false },
+    { "straddles right", { 10.0f, 0.0f, 0.0f }, unit, true },
+    { "straddles near", { 0.0f, 0.0f, 9.0f }, (Vector3){ 0.5f, 0.5f, 0.5f }, true },
+    { "straddles far", { 0.0f, 0.0f, -90.0f }, unit, true },
+  };
+  failed += check_boxes(&pf, perspectiveBoxes, (int)(sizeof(perspectiveBoxes) / sizeof(perspectiveBoxes[0])));
+
+  const CheckBox orthoBoxes[] = {
+    { "ortho inside", { 0.0f, 0.0f, 0.0f }, unit, true },
+    { "ortho outside left", { -12.0f, 0.0f, 0.0f }, unit, false },
+    { "ortho outside bottom", { 0.0f, -7.0f, 0.0f }, unit, false },
+    { "ortho straddles top", { 0.0f, 5.0f, 0.0f }, unit, true },
+    { "ortho straddles far", { 0.0f, 0.0f, -40.0f }, unit, true },
+  };
+  failed += check_boxes(&of, orthoBoxes, (int)(sizeof(orthoBoxes) / sizeof(orthoBoxes[0])));
+
+  if (failed) {
+    printf("FAIL culling known answers: %d wrong\n", failed);
+  } else {
+    printf("culling known answers ok\n");
+  }
+  return failed;
+}
+
+int main(){
+  if (culling_known_answers() > 0) return 1;
+
+  Camera3D camera = {
+    .position = (Vector3){ 10.0f, 10.0f, 10.0f },
+    .target = (Vector3){ 0.0f, 0.0f, 0.0f },
+    .up = (Vector3){ 0.0f, 1.0f, 0.0f },
+    .fovy = 45.0f,
+    .projection = CAMERA_PERSPECTIVE
+  };
+  Frustum3D frustum = culling_frustum_from_camera(camera, 16.0f / 9.0f, 0.01f, 1000.0f);
+
+  WorldBounds3D *bounds = ecs_os_malloc_n(WorldBounds3D, BENCH_COUNT);
+  for (int i = 0; i < BENCH_COUNT; i++) {
+    BoundingBox box = { (Vector3){ -0.5f, -0.5f, -0.5f }, (Vector3){ 0.5f, 0.5f, 0.5f } };
+    Matrix world = MatrixMultiply(MatrixRotateY(bench_rand(PI)),
+      MatrixTranslate(bench_rand(200.0f), bench_rand(50.0f), bench_rand(200.0f)));
+    culling_world_bounds(&box, &world, &bounds[i]);
+  }
+
+  ecs_time_t t = {0};
+  int32_t scalarVisible = 0;
+  ecs_time_measure(&t);
+  for (int r = 0; r < BENCH_REPEAT; r++) {
+    scalarVisible = 0;
+    for (int i = 0; i < BENCH_COUNT; i++) {
+      bounds[i].isVisible = culling_test_aabb(&frustum, bounds[i].center, bounds[i].extents);
+      scalarVisible += bounds[i].isVisible;
+    }
+  }
+  double scalar = ecs_time_measure(&t) / BENCH_REPEAT;
+
+  int32_t batchVisible = 0;
+  for (int r = 0; r < BENCH_REPEAT; r++) {
+    batchVisible = culling_test_aabb_batch(&frustum,
+      &bounds[0].center, sizeof(WorldBounds3D),
+      &bounds[0].extents, sizeof(WorldBounds3D),
+      &bounds[0].isVisible, sizeof(WorldBounds3D),
+      BENCH_COUNT);
+  }
+  double batch = ecs_time_measure(&t) / BENCH_REPEAT;
+
+  printf("%d boxes | scalar %8.3f ms visible %d culled %d\n",
+    BENCH_COUNT, scalar * 1000.0, scalarVisible, BENCH_COUNT - scalarVisible);
+  printf("%d boxes | batch  %8.3f ms visible %d culled %d\n",
+    BENCH_COUNT, batch * 1000.0, batchVisible, BENCH_COUNT - batchVisible);
+
+  ecs_os_free(bounds);
+  return scalarVisible == batchVisible ? 0 : 1;
+}
@@ -0,0 +1,220 @@
+// headless transform hierarchy benchmark
+// known answers first: the batch kernel and transform_matrix_multiply against
+// raymath for edge case and random TRS values, any result more than 1 ulp off
+// (the sign of zero aside) fails the run before the timing.
+// then builds 4-ary trees of 10k, 100k and 1M transform nodes and times
+// the flat hierarchy rebuild and propagation passes. no window needed.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "flecs_raylib.h"
+#include "flecs_transform.h"
+#include "transform_kernel.h"
+
+#define BENCH_FRAMES 10
+#define CHECK_RANDOM 32                  // with the edge cases not a multiple of 8, the scalar tail runs too
+#define CHECK_MAX_ULPS 1
+
+static float bench_rand(float range){
+  return ((float)rand() / (float)RAND_MAX * 2.0f - 1.0f) * range;
+}
+
+// ulps between two floats, +0 and -0 are equal
+static int64_t check_ulps(float a, float b){
+  if (a == b) return 0;
+  if (isnan(a) || isnan(b)) return INT64_MAX;
+  int32_t ia, ib;
+  memcpy(&ia, &a, sizeof(ia));
+  memcpy(&ib, &b, sizeof(ib));
+  // sign magnitude to a monotonic integer line
+  int64_t la = ia < 0 ? -(int64_t)(ia & 0x7fffffff) : ia;
+  int64_t lb = ib < 0 ? -(int64_t)(ib & 0x7fffffff) : ib;
+  return la > lb ? la - lb : lb - la;
+}
+
+static int check_matrix(const char *what, int32_t i, const Matrix *got, const Matrix *want){
+  const float *g = (const float *)got;
+  const float *w = (const float *)want;
+  for (int k = 0; k < 16; k++) {
+    if (check_ulps(g[k], w[k]) > CHECK_MAX_ULPS) {
+      printf("FAIL %s %d m%d: got %.9g want %.9g\n", what, i, k, g[k], w[k]);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static Matrix check_raymath_trs(Vector3 p, Quaternion q, Vector3 s){
+  return MatrixMultiply(MatrixScale(s.x, s.y, s.z),
+    MatrixMultiply(QuaternionToMatrix(q), MatrixTranslate(p.x, p.y, p.z)));
+}
+
+static int transform_known_answers(void){
+  enum { EDGE = 7, COUNT = EDGE + CHECK_RANDOM };
+  Vector3 pos[COUNT];
+  Quaternion rot[COUNT];
+  Vector3 scale[COUNT];
+  Matrix out[COUNT];
+
+  // identity
+  pos[0] = (Vector3){ 0.0f, 0.0f, 0.0f };
+  rot[0] = (Quaternion){ 0.0f, 0.0f, 0.0f, 1.0f };
+  scale[0] = (Vector3){ 1.0f, 1.0f, 1.0f };
+  // -0 everywhere a zero can be
+  pos[1] = (Vector3){ -0.0f, -0.0f, -0.0f };
+  rot[1] = (Quaternion){ -0.0f, -0.0f, -0.0f, 1.0f };
+  scale[1] = (Vector3){ 1.0f, -0.0f, 1.0f };
+  // non-uniform and negative scale
+  pos[2] = (Vector3){ 3.0f, -2.0f, 0.5f };
+  rot[2] = QuaternionFromEuler(0.3f, -1.2f, 2.0f);
+  scale[2] = (Vector3){ 0.25f, 4.0f, -3.0f };
+  // unnormalized quaternions, raymath does not normalize either
+  pos[3] = (Vector3){ 1.0f, 1.0f, 1.0f };
+  rot[3] = (Quaternion){ 0.5f, 1.0f, -2.0f, 3.0f };
+  scale[3] = (Vector3){ 1.0f, 1.0f, 1.0f };
+  pos[4] = (Vector3){ -7.0f, 0.0f, 100.0f };
+  rot[4] = (Quaternion){ 0.0f, 0.0f, 0.0f, 0.0f };
+  scale[4] = (Vector3){ 2.0f, 2.0f, 2.0f };
+  // half turns, -0 products in the rotation terms
+  pos[5] = (Vector3){ 0.0f, 1.0f, 0.0f };
+  rot[5] = (Quaternion){ 0.0f, 1.0f, 0.0f, 0.0f };
+  scale[5] = (Vector3){ 1.0f, 1.0f, -1.0f };
+  pos[6] = (Vector3){ 1e6f, -1e-6f, 0.0f };
+  rot[6] = (Quaternion){ -1.0f, 0.0f, 0.0f, -0.0f };
+  scale[6] = (Vector3){ 1e-3f, 1e3f, 1.0f };
+
+  srand(1);
+  for (int32_t i = EDGE; i < COUNT; i++) {
+    pos[i] = (Vector3){ bench_rand(100.0f), bench_rand(100.0f), bench_rand(100.0f) };
+    rot[i] = (Quaternion){ bench_rand(1.0f), bench_rand(1.0f), bench_rand(1.0f), bench_rand(1.0f) };
+    if (i % 2) rot[i] = QuaternionNormalize(rot[i]);
+    scale[i] = (Vector3){ bench_rand(10.0f), bench_rand(10.0f), bench_rand(10.0f) };
+  }
+
+  int failed = 0;
+  transform_compose_batch(pos, rot, scale, out, COUNT);
+  for (int32_t i = 0; i < COUNT; i++) {
+    Matrix want = check_raymath_trs(pos[i], rot[i], scale[i]);
+    failed += check_matrix("batch", i, &out[i], &want);
+
+    Matrix single;
+    transform_compose_scalar(pos[i], rot[i], scale[i], &single);
+    failed += check_matrix("scalar", i, &single, &want);
+  }
+
+  // parent * child, as the hierarchy propagation does
+  for (int32_t i = 0; i < COUNT; i++) {
+    const Matrix *parent = &out[(i + 1) % COUNT];
+    Matrix got;
+    transform_matrix_multiply(&out[i], parent, &got);
+    Matrix want = MatrixMultiply(out[i], *parent);
+    failed += check_matrix("multiply", i, &got, &want);
+  }
+
+  if (failed) {
+    printf("FAIL transform known answers: %d wrong (%s)\n", failed, transform_kernel_name());
+  } else {
+    printf("transform known answers ok (%s)\n", transform_kernel_name());
+  }
+  return failed;
+}
+
+static void bench_tree(int32_t count){
+  ecs_world_t *world = ecs_init();
+  transform_hierarchy_init(world);
+
+  // 1 root per 1000 nodes, every other node is a child of an earlier node
+  int32_t roots = count / 1000 > 0 ? count / 1000 : 1;
+  ecs_entity_t *nodes = ecs_os_malloc_n(ecs_entity_t, count);
+  for (int32_t i = 0; i < count; i++) {
+    nodes[i] = ecs_new(world);
+    ecs_set(world, nodes[i], LocalTransform3D, {
+      .position = (Vector3){ (float)(i % 7), 1.0f, 0.0f },
+      .rotation = QuaternionIdentity(),
+      .scale = (Vector3){ 1.0f, 1.0f, 1.0f }
+    });
+    if (i >= roots) {
+      ecs_add_pair(world, nodes[i], EcsChildOf, nodes[(i - roots) / 4]);
+    }
+  }
+
+  TransformHierarchy *th = ecs_singleton_ensure(world, TransformHierarchy);
+
+  ecs_time_t t = {0};
+  ecs_time_measure(&t);
+  transform_hierarchy_rebuild(world, th);
+  double rebuild = ecs_time_measure(&t);
+
+  transform_hierarchy_propagate(world, th);
+  double full = ecs_time_measure(&t);
+
+  // nothing dirty, cost of walking the node list
+  for (int f = 0; f < BENCH_FRAMES; f++) {
+    transform_hierarchy_propagate(world, th);
+  }
+  double idle = ecs_time_measure(&t) / BENCH_FRAMES;
+
+  // every root moves, whole tree is recomputed
+  for (int f = 0; f < BENCH_FRAMES; f++) {
+    for (int32_t i = 0; i < roots; i++) {
+      LocalTransform3D *root = ecs_get_mut(world, nodes[i], LocalTransform3D);
+      root->position.y += 0.01f;
+      ecs_modified(world, nodes[i], LocalTransform3D);
+    }
+    transform_hierarchy_propagate(world, th);
+  }
+  double moving = ecs_time_measure(&t) / BENCH_FRAMES;
+
+  printf("%8d nodes | rebuild %8.3f ms | full %8.3f ms | idle %8.3f ms | roots moving %8.3f ms\n",
+    count, rebuild * 1000.0, full * 1000.0, idle * 1000.0, moving * 1000.0);
+
+  transform_hierarchy_fini(world);
+  ecs_os_free(nodes);
+  ecs_fini(world);
+}
+
+// raymath one entity at a time vs the batch kernel on packed arrays
+static void bench_compose(int32_t count){
+  Vector3 *pos = ecs_os_malloc_n(Vector3, count);
+  Quaternion *rot = ecs_os_malloc_n(Quaternion, count);
+  Vector3 *scale = ecs_os_malloc_n(Vector3, count);
+  Matrix *out = ecs_os_malloc_n(Matrix, count);
+  for (int32_t i = 0; i < count; i++) {
+    pos[i] = (Vector3){ (float)(i % 7), 1.0f, 0.0f };
+    rot[i] = QuaternionFromEuler(0.1f * (float)(i % 13), 0.2f, 0.0f);
+    scale[i] = (Vector3){ 1.0f, 2.0f, 1.0f };
+  }
+
+  ecs_time_t t = {0};
+  ecs_time_measure(&t);
+  for (int f = 0; f < BENCH_FRAMES; f++) {
+    for (int32_t i = 0; i < count; i++) {
+      out[i] = MatrixMultiply(MatrixScale(scale[i].x, scale[i].y, scale[i].z),
+        MatrixMultiply(QuaternionToMatrix(rot[i]), MatrixTranslate(pos[i].x, pos[i].y, pos[i].z)));
+    }
+  }
+  double scalar = ecs_time_measure(&t) / BENCH_FRAMES;
+
+  for (int f = 0; f < BENCH_FRAMES; f++) {
+    transform_compose_batch(pos, rot, scale, out, count);
+  }
+  double batch = ecs_time_measure(&t) / BENCH_FRAMES;
+
+  printf("%8d TRS   | raymath %8.3f ms | %s batch %8.3f ms\n",
+    count, scalar * 1000.0, transform_kernel_name(), batch * 1000.0);
+
+  ecs_os_free(pos);
+  ecs_os_free(rot);
+  ecs_os_free(scale);
+  ecs_os_free(out);
+}
+
+int main(){
+  if (transform_known_answers() > 0) return 1;
+  bench_compose(1000000);
+  bench_tree(10000);
+  bench_tree(100000);
+  bench_tree(1000000);
+  return 0;
+}
@@ -0,0 +1,77 @@
+// headless transform layout microbenchmark
+// compares the old packed Transform3D (AoS) with the split hot/cold
+// components for the three passes that run every frame:
+// position read (gameplay), dirty scan (propagation), world read (render).
+// the dirty state is a 1 byte per node array in the hierarchy cache now.
+#include <stdio.h>
+#include "flecs_raylib.h"
+
+#define BENCH_COUNT 1000000
+#define BENCH_REPEAT 20
+
+static volatile float g_sink;
+
+static void bench_print(const char *name, size_t stride, double seconds){
+  double bytes = (double)stride * BENCH_COUNT * BENCH_REPEAT;
+  printf("%-34s stride %4d B | %8.3f ms | %6.2f GB/s strided\n",
+    name, (int)stride, seconds * 1000.0 / BENCH_REPEAT, bytes / seconds / 1e9);
+}
+
+int main(){
+  Transform3D *packed = ecs_os_calloc_n(Transform3D, BENCH_COUNT);
+  LocalTransform3D *local = ecs_os_calloc_n(LocalTransform3D, BENCH_COUNT);
+  WorldTransform3D *world = ecs_os_calloc_n(WorldTransform3D, BENCH_COUNT);
+  bool *dirty = ecs_os_calloc_n(bool, BENCH_COUNT);
+
+  for (int i = 0; i < BENCH_COUNT; i++) {
+    packed[i].position = (Vector3){ (float)i, 1.0f, 2.0f };
+    packed[i].worldMatrix = MatrixIdentity();
+    packed[i].isDirty = (i % 64) == 0;
+    local[i].position = packed[i].position;
+    world[i].worldMatrix = packed[i].worldMatrix;
+    dirty[i] = packed[i].isDirty;
+  }
+
+  ecs_time_t t = {0};
+  float sum = 0.0f;
+  int dirtyCount = 0;
+
+  // position read
+  ecs_time_measure(&t);
+  for (int r = 0; r < BENCH_REPEAT; r++) {
+    for (int i = 0; i < BENCH_COUNT; i++) sum += packed[i].position.x;
+  }
+  bench_print("position  Transform3D", sizeof(Transform3D), ecs_time_measure(&t));
+  for (int r = 0; r < BENCH_REPEAT; r++) {
+    for (int i = 0; i < BENCH_COUNT; i++) sum += local[i].position.x;
+  }
+  bench_print("position  LocalTransform3D", sizeof(LocalTransform3D), ecs_time_measure(&t));
+
+  // dirty scan
+  for (int r = 0; r < BENCH_REPEAT; r++) {
+    for (int i = 0; i < BENCH_COUNT; i++) dirtyCount += packed[i].isDirty;
+  }
+  bench_print("dirty     Transform3D", sizeof(Transform3D), ecs_time_measure(&t));
+  for (int r = 0; r < BENCH_REPEAT; r++) {
+    for (int i = 0; i < BENCH_COUNT; i++) dirtyCount += dirty[i];
+  }
+  bench_print("dirty     bool", sizeof(bool), ecs_time_measure(&t));
+
+  // world matrix read
+  for (int r = 0; r < BENCH_REPEAT; r++) {
+    for (int i = 0; i < BENCH_COUNT; i++) sum += packed[i].worldMatrix.m12;
+  }
+  bench_print("world     Transform3D", sizeof(Transform3D), ecs_time_measure(&t));
+  for (int r = 0; r < BENCH_REPEAT; r++) {
+    for (int i = 0; i < BENCH_COUNT; i++) sum += world[i].worldMatrix.m12;
+  }
+  bench_print("world     WorldTransform3D", sizeof(WorldTransform3D), ecs_time_measure(&t));
+
+  g_sink = sum + (float)dirtyCount;
+
+  ecs_os_free(packed);
+  ecs_os_free(local);
+  ecs_os_free(world);
+  ecs_os_free(dirty);
+  return 0;
+}
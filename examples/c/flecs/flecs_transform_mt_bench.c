@@ -0,0 +1,64 @@
+// headless transform hierarchy thread scaling benchmark
+// 1M nodes in 1000 root subtrees, every root moves each frame so the whole
+// tree is recomputed. runs the real systems with ecs_progress on 1..N threads.
+// usage: flecs_transform_mt_bench [max threads] (default 8)
+#include <stdio.h>
+#include <stdlib.h>
+#include "flecs_raylib.h"
+#include "flecs_transform.h"
+
+#define BENCH_NODES 1000000
+#define BENCH_ROOTS 1000
+#define BENCH_FRAMES 20
+
+static double bench_threads(int32_t threads){
+  ecs_world_t *world = ecs_init();
+  transform_hierarchy_init(world);
+  transform_hierarchy_register_systems(world, EcsOnUpdate);
+  transform_hierarchy_set_threads(world, threads);
+
+  ecs_entity_t *nodes = ecs_os_malloc_n(ecs_entity_t, BENCH_NODES);
+  for (int32_t i = 0; i < BENCH_NODES; i++) {
+    nodes[i] = ecs_new(world);
+    ecs_set(world, nodes[i], LocalTransform3D, {
+      .position = (Vector3){ (float)(i % 7), 1.0f, 0.0f },
+      .rotation = QuaternionIdentity(),
+      .scale = (Vector3){ 1.0f, 1.0f, 1.0f }
+    });
+    if (i >= BENCH_ROOTS) {
+      ecs_add_pair(world, nodes[i], EcsChildOf, nodes[(i - BENCH_ROOTS) / 4]);
+    }
+  }
+
+  // first frame rebuilds the cache
+  ecs_progress(world, 0);
+
+  ecs_time_t t = {0};
+  double total = 0.0;
+  for (int f = 0; f < BENCH_FRAMES; f++) {
+    for (int32_t i = 0; i < BENCH_ROOTS; i++) {
+      ecs_get_mut(world, nodes[i], LocalTransform3D)->position.y += 0.01f;
+      ecs_modified(world, nodes[i], LocalTransform3D);
+    }
+    ecs_time_measure(&t);
+    ecs_progress(world, 0);
+    total += ecs_time_measure(&t);
+  }
+
+  transform_hierarchy_fini(world);
+  ecs_os_free(nodes);
+  ecs_fini(world);
+  return total / BENCH_FRAMES;
+}
+
+int main(int argc, char **argv){
+  int32_t max_threads = argc > 1 ? atoi(argv[1]) : 8;
+  double base = 0.0;
+  for (int32_t threads = 1; threads <= max_threads; threads *= 2) {
+    double frame = bench_threads(threads);
+    if (threads == 1) base = frame;
+    printf("%2d threads | %8d nodes | frame %8.3f ms | speedup %5.2fx\n",
+      threads, BENCH_NODES, frame * 1000.0, base / frame);
+  }
+  return 0;
+}
@@ -0,0 +1,73 @@
+// headless render queue benchmark
+// 100k instances over 8 meshes x 3 tints x 2 layers in random order, times
+// the per frame add + radix sort + build and checks every group is
+// contiguous, groups come in key order and instances go front to back.
+#include <stdio.h>
+#include <stdlib.h>
+#include "render_batch.h"
+#include "raymath.h"
+
+#define BENCH_COUNT 100000
+#define BENCH_MESHES 8
+#define BENCH_FRAMES 20
+
+int main(){
+  // cpu only, no mesh data is uploaded
+  Mesh meshes[BENCH_MESHES] = {0};
+  Material material = {0};
+  Color tints[3] = { RED, GRAY, BLUE };
+
+  int32_t *meshOf = ecs_os_malloc_n(int32_t, BENCH_COUNT);
+  int32_t *tintOf = ecs_os_malloc_n(int32_t, BENCH_COUNT);
+  float *depthOf = ecs_os_malloc_n(float, BENCH_COUNT);
+  Matrix *world = ecs_os_malloc_n(Matrix, BENCH_COUNT);
+  for (int32_t i = 0; i < BENCH_COUNT; i++) {
+    meshOf[i] = rand() % BENCH_MESHES;
+    tintOf[i] = rand() % 3;
+    depthOf[i] = (float)rand() / (float)RAND_MAX;
+    // m12 keeps the instance index
+    world[i] = MatrixTranslate((float)i, (float)meshOf[i], (float)tintOf[i]);
+  }
+
+  RenderBatcher batch;
+  render_batch_init(&batch);
+
+  ecs_time_t t = {0};
+  ecs_time_measure(&t);
+  for (int f = 0; f < BENCH_FRAMES; f++) {
+    render_batch_begin(&batch);
+    for (int32_t i = 0; i < BENCH_COUNT; i++) {
+      render_batch_add(&batch, &meshes[meshOf[i]], &material, tints[tintOf[i]],
+        (uint8_t)(i & 1), depthOf[i], &world[i]);
+    }
+    render_batch_build(&batch);
+  }
+  double frame = ecs_time_measure(&t) / BENCH_FRAMES;
+
+  // each group range holds only its own mesh/tint (encoded in m13/m14)
+  int32_t total = 0;
+  int32_t errors = 0;
+  for (int32_t g = 0; g < batch.groupCount; g++) {
+    const RenderBatchGroup *group = &batch.groups[g];
+    int32_t mesh = (int32_t)(group->mesh - meshes);
+    if (g > 0 && batch.groups[g - 1].key >= group->key) errors++;
+    for (int32_t i = group->start; i < group->start + group->count; i++) {
+      int32_t index = (int32_t)batch.transforms[i].m12;
+      if ((int32_t)batch.transforms[i].m13 != mesh) errors++;
+      if (ColorToInt(tints[(int32_t)batch.transforms[i].m14]) != ColorToInt(group->tint)) errors++;
+      // equal after 24 bit quantization keeps add order
+      if (i > group->start && depthOf[(int32_t)batch.transforms[i - 1].m12] > depthOf[index] + 1e-6f) errors++;
+    }
+    total += group->count;
+  }
+
+  printf("%d instances | %d groups (draw calls) | add+sort+build %8.3f ms | errors %d\n",
+    total, batch.groupCount, frame * 1000.0, errors);
+
+  render_batch_fini(&batch);
+  ecs_os_free(meshOf);
+  ecs_os_free(tintOf);
+  ecs_os_free(depthOf);
+  ecs_os_free(world);
+  return errors == 0 && total == BENCH_COUNT ? 0 : 1;
+}
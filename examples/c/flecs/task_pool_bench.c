@@ -0,0 +1,172 @@
+// headless task pool scaling benchmark
+// parallel for over 1M root transforms (compose) and 1M world boxes (culling),
+// plus a nested fork join tree that only balances through stealing.
+// usage: task_pool_bench [max threads] (default 8)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "flecs_culling.h"
+#include "flecs_transform.h"
+#include "transform_kernel.h"
+#include "task_pool.h"
+
+#define BENCH_COUNT 1000000
+#define BENCH_REPEAT 20
+#define BENCH_GRAIN 4096
+#define BENCH_TREE_DEPTH 16                     // 65536 leaves
+#define BENCH_LEAF_WORK 2000
+
+typedef struct {
+  LocalTransform3D *local;
+  WorldTransform3D *world;
+} ComposeBench;
+
+typedef struct {
+  Frustum3D frustum;
+  WorldBounds3D *bounds;
+  int32_t visible[TASK_POOL_MAX_WORKERS + 1];
+} CullBench;
+
+typedef struct {
+  TaskPool *pool;
+  int32_t depth;
+  uint32_t seed;
+  float result;
+} TreeNode;
+
+static float bench_rand(float range){
+  return ((float)rand() / (float)RAND_MAX * 2.0f - 1.0f) * range;
+}
+
+static void compose_range(void *ctx, int32_t begin, int32_t end, int32_t worker){
+  (void)worker;
+  ComposeBench *b = ctx;
+  transform_compose_batch_strided(
+    &b->local[begin].position, sizeof(LocalTransform3D),
+    &b->local[begin].rotation, sizeof(LocalTransform3D),
+    &b->local[begin].scale, sizeof(LocalTransform3D),
+    &b->world[begin].worldMatrix, end - begin);
+}
+
+static void cull_range(void *ctx, int32_t begin, int32_t end, int32_t worker){
+  CullBench *b = ctx;
+  b->visible[worker] += culling_test_aabb_batch(&b->frustum,
+    &b->bounds[begin].center, sizeof(WorldBounds3D),
+    &b->bounds[begin].extents, sizeof(WorldBounds3D),
+    &b->bounds[begin].isVisible, sizeof(WorldBounds3D),
+    end - begin);
+}
+
+// uneven leaves so a static split would leave threads idle
+static void tree_task(void *ctx, int32_t worker){
+  (void)worker;
+  TreeNode *node = ctx;
+  if (node->depth == 0) {
+    uint32_t s = node->seed;
+    int32_t work = BENCH_LEAF_WORK * (int32_t)(1 + s % 4);
+    float acc = 0.0f;
+    for (int32_t i = 0; i < work; i++) {
+      s = s * 1664525u + 1013904223u;
+      acc += (float)(s >> 8) * (1.0f / 16777216.0f);
+    }
+    node->result = acc;
+    return;
+  }
+  TaskGroup group = {0};
+  TreeNode left = { node->pool, node->depth - 1, node->seed * 2 + 1, 0.0f };
+  TreeNode right = { node->pool, node->depth - 1, node->seed * 2 + 2, 0.0f };
+  task_pool_spawn(node->pool, &group, tree_task, &left);
+  tree_task(&right, worker);
+  task_pool_wait(node->pool, &group);
+  node->result = left.result + right.result;
+}
+
+static int64_t bench_stolen(const TaskPool *p){
+  int64_t stolen = 0;
+  for (int32_t i = 0; i < task_pool_threads(p); i++) stolen += p->stats[i].stolen;
+  return stolen;
+}
+
+int main(int argc, char **argv){
+  int32_t max_threads = argc > 1 ? atoi(argv[1]) : 8;
+  if (max_threads > TASK_POOL_MAX_WORKERS + 1) max_threads = TASK_POOL_MAX_WORKERS + 1;
+  // os api (threads, locks) comes with the world
+  ecs_world_t *ecs = ecs_init();
+
+  ComposeBench compose = {
+    .local = ecs_os_malloc_n(LocalTransform3D, BENCH_COUNT),
+    .world = ecs_os_malloc_n(WorldTransform3D, BENCH_COUNT)
+  };
+  for (int32_t i = 0; i < BENCH_COUNT; i++) {
+    compose.local[i] = (LocalTransform3D){
+      .position = (Vector3){ bench_rand(100.0f), bench_rand(100.0f), bench_rand(100.0f) },
+      .rotation = QuaternionFromEuler(bench_rand(PI), bench_rand(PI), 0.0f),
+      .scale = (Vector3){ 1.0f, 1.0f, 1.0f }
+    };
+  }
+
+  Camera3D camera = {
+    .position = (Vector3){ 10.0f, 10.0f, 10.0f },
+    .target = (Vector3){ 0.0f, 0.0f, 0.0f },
+    .up = (Vector3){ 0.0f, 1.0f, 0.0f },
+    .fovy = 45.0f,
+    .projection = CAMERA_PERSPECTIVE
+  };
+  CullBench cull = {
+    .frustum = culling_frustum_from_camera(camera, 16.0f / 9.0f, 0.01f, 1000.0f),
+    .bounds = ecs_os_malloc_n(WorldBounds3D, BENCH_COUNT)
+  };
+  for (int32_t i = 0; i < BENCH_COUNT; i++) {
+    BoundingBox box = { (Vector3){ -0.5f, -0.5f, -0.5f }, (Vector3){ 0.5f, 0.5f, 0.5f } };
+    Matrix world = MatrixTranslate(bench_rand(200.0f), bench_rand(50.0f), bench_rand(200.0f));
+    culling_world_bounds(&box, &world, &cull.bounds[i]);
+  }
+
+  double baseCompose = 0.0, baseCull = 0.0, baseTree = 0.0;
+  int32_t baseVisible = -1;
+  for (int32_t threads = 1; threads <= max_threads; threads *= 2) {
+    TaskPool pool;
+    task_pool_init(&pool, threads - 1);
+    ecs_time_t t = {0};
+
+    ecs_time_measure(&t);
+    for (int r = 0; r < BENCH_REPEAT; r++) {
+      task_pool_parallel_for(&pool, BENCH_COUNT, BENCH_GRAIN, compose_range, &compose);
+    }
+    double composeMs = ecs_time_measure(&t) * 1000.0 / BENCH_REPEAT;
+
+    int32_t visible = 0;
+    ecs_time_measure(&t);
+    for (int r = 0; r < BENCH_REPEAT; r++) {
+      memset(cull.visible, 0, sizeof(cull.visible));
+      task_pool_parallel_for(&pool, BENCH_COUNT, BENCH_GRAIN, cull_range, &cull);
+    }
+    double cullMs = ecs_time_measure(&t) * 1000.0 / BENCH_REPEAT;
+    for (int32_t w = 0; w < threads; w++) visible += cull.visible[w];
+    if (baseVisible < 0) baseVisible = visible;
+
+    task_pool_stats_reset(&pool);
+    TreeNode root = { &pool, BENCH_TREE_DEPTH, 1, 0.0f };
+    ecs_time_measure(&t);
+    tree_task(&root, 0);
+    double treeMs = ecs_time_measure(&t) * 1000.0;
+    int64_t stolen = bench_stolen(&pool);
+
+    task_pool_fini(&pool);
+
+    if (threads == 1) {
+      baseCompose = composeMs;
+      baseCull = cullMs;
+      baseTree = treeMs;
+    }
+    printf("%2d threads | compose %7.3f ms %5.2fx | cull %7.3f ms %5.2fx %s | fork join %8.3f ms %5.2fx, %lld steals\n",
+      threads, composeMs, baseCompose / composeMs, cullMs, baseCull / cullMs,
+      visible == baseVisible ? "ok" : "MISMATCH", treeMs, baseTree / treeMs, (long long)stolen);
+  }
+
+  ecs_os_free(compose.local);
+  ecs_os_free(compose.world);
+  ecs_os_free(cull.bounds);
+  ecs_fini(ecs);
+  return 0;
+}
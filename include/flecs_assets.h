@@ -0,0 +1,133 @@
+#ifndef FLECS_ASSETS_H
+#define FLECS_ASSETS_H
+
+#include <stdint.h>
+#include "flecs.h"
+#include "raylib.h"
+#include "task_pool.h"
+
+// Refcounted model registry.
+// Every unique source (file path or procedural parameters) is loaded once,
+// entities hold a small handle. When the last handle is released the model
+// is unreachable at once and unloaded later through the job queue.
+//
+// Async loads hand out the handle at once. The CPU side (file read, decode,
+// mesh generation) runs on the task pool, the GPU upload on the main thread in
+// asset_upload_system, ASSET_UPLOAD_BUDGET_US per frame. Until then the entry
+// is pending and draws as the placeholder model.
+// Model files only get the file read on the task pool: raylib has no CPU only
+// model parse, LoadModel parses them from the read bytes in the upload step.
+
+#define ASSET_UPLOAD_BUDGET_US 2000
+
+// index is slot + 1 (0 = no model), generation catches stale handles
+typedef struct {
+  uint32_t index;
+  uint32_t generation;
+} ModelHandle;
+
+typedef struct {
+  uint64_t key;                         // Hash of path or procedural parameters
+  char name[64];                        // Debug name
+  Model model;
+  int32_t refCount;
+  uint32_t generation;
+  bool isLoaded;                        // Slot in use, resident or pending
+  bool isResident;                      // model is valid (uploaded)
+  int64_t residentFrame;                // Upload step that made it resident
+  int32_t nextFree;                     // Free list when not loaded
+} AssetEntry;
+
+typedef enum {
+  ASSET_LOAD_OK,
+  ASSET_LOAD_FAILED,                    // decode returned false / upload failed
+  ASSET_LOAD_CANCELLED                  // asset_registry_fini, free the CPU data only
+} AssetLoadStatus;
+
+// Task pool thread: CPU only, no GL and no raylib calls that log (the console
+// log callback is main thread only). Returns false on failure.
+typedef bool (*AssetDecodeCallback)(void *ctx);
+// Main thread, called exactly once per load. Returns the outcome: OK when
+// the model is resident, FAILED when it is not (decode or upload failed, the
+// entry leaves the index so the next load of it retries), CANCELLED when
+// nothing waits for it any more.
+typedef AssetLoadStatus (*AssetUploadCallback)(ecs_world_t *world, void *ctx, AssetLoadStatus status);
+
+typedef struct {
+  char name[32];
+  AssetDecodeCallback decode;
+  AssetUploadCallback upload;
+  void *ctx;
+  TaskGroup group;                      // Decode in flight
+  bool isSpawned;                       // false = no workers, decode in the upload step
+  bool isDecoded;
+  uint64_t queuedTime;                  // ecs_os_now
+} AssetLoad;
+
+typedef struct {
+  int64_t queued;
+  int64_t uploaded;
+  int64_t failed;
+  int32_t lastUploads;                  // Upload step of the last frame
+  float lastUs;
+  int64_t overBudgetFrames;
+  float maxLatencyMs;                   // Queued to uploaded
+} AssetLoadStats;
+
+typedef struct {
+  AssetEntry *entries;
+  int32_t count;
+  int32_t capacity;
+  int32_t freeHead;                     // -1 = none
+  ecs_map_t index;                      // key -> entry slot, a hit compares the name too
+  int32_t loaded;                       // Unique models resident now
+  bool isClosed;                        // After asset_registry_fini, release is a no op
+  bool isHeadless;                      // No GL context, meshes stay CPU side
+  AssetLoad **loads;                    // Async loads not uploaded yet, FIFO
+  int32_t loadCount;
+  int32_t loadCapacity;
+  int32_t uploadBudgetUs;
+  int64_t uploadFrame;                  // Upload steps run
+  Model placeholder;                    // Drawn for pending entries
+  bool hasPlaceholder;
+  AssetLoadStats loadStats;
+} AssetRegistry;
+ECS_COMPONENT_DECLARE(AssetRegistry);
+
+void asset_registry_init(ecs_world_t *world);
+// Unloads everything still loaded, call before CloseWindow
+void asset_registry_fini(ecs_world_t *world);
+// Headless, procedural meshes are built without UploadMesh and model files
+// are skipped (LoadModel uploads)
+void asset_registry_set_headless(ecs_world_t *world, bool headless);
+
+// Returned handle owns one reference, release it (rl_model_set does, the
+// ModelComponent acquires its own)
+ModelHandle asset_model_load(ecs_world_t *world, const char *path);
+ModelHandle asset_model_cube(ecs_world_t *world, float width, float height, float length);
+
+// Pending handle, resident after a later upload step
+ModelHandle asset_model_load_async(ecs_world_t *world, const char *path);
+ModelHandle asset_model_cube_async(ecs_world_t *world, float width, float height, float length);
+
+// Generic async load, ctx belongs to the callbacks. false when there is no
+// registry, the caller loads synchronously then.
+bool asset_load_async(ecs_world_t *world, const char *name, AssetDecodeCallback decode, AssetUploadCallback upload, void *ctx);
+void asset_set_upload_budget(ecs_world_t *world, int32_t budgetUs);
+// Uploads decoded loads in FIFO order until budgetUs is used, at least one.
+// Returns the uploads.
+int32_t asset_upload_run(AssetRegistry *reg, ecs_world_t *world, int32_t budgetUs);
+void asset_load_print(const AssetRegistry *reg);
+void asset_register_systems(ecs_world_t *world);
+
+ModelHandle asset_model_acquire(ecs_world_t *world, ModelHandle handle);
+void asset_model_release(ecs_world_t *world, ModelHandle handle);
+
+// NULL when the handle is stale, empty or still pending
+Model *asset_model_get(const ecs_world_t *world, ModelHandle handle);
+// Pending handles get the placeholder (NULL before the first upload step)
+Model *asset_model_get_or_placeholder(const ecs_world_t *world, ModelHandle handle);
+// Became resident in the last upload step, for state derived from the model
+bool asset_model_is_fresh(const ecs_world_t *world, ModelHandle handle);
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef FLECS_CULLING_H
+#define FLECS_CULLING_H
+
+#include <stddef.h>
+#include "flecs_module.h"
+#include "flecs_raylib.h"
+
+// CPU frustum culling.
+// LocalBounds3D is filled from the mesh bounds when a ModelComponent is set,
+// WorldBounds3D is kept up to date from WorldTransform3D in the cull phase and
+// tested against the RayLibContext camera frustum 4 boxes at a time (SSE2).
+// Nothing here needs a window or GPU, only CPU side mesh data.
+
+// Mesh space bounds
+typedef struct {
+  BoundingBox box;
+} LocalBounds3D;
+ECS_COMPONENT_DECLARE(LocalBounds3D);
+
+// World space AABB (center, half extents) and the result of the last cull
+typedef struct {
+  Vector3 center;
+  Vector3 extents;
+  bool isVisible;
+} WorldBounds3D;
+ECS_COMPONENT_DECLARE(WorldBounds3D);
+
+// Plane (x, y, z) normal pointing inside, w distance: dot(n, p) + w >= 0 inside.
+// Order: left, right, bottom, top, near, far
+typedef struct {
+  Vector4 planes[6];
+} Frustum3D;
+
+typedef struct {
+  Frustum3D frustum;                    // Camera frustum of this frame
+  bool isEnabled;                       // false = everything visible
+  int32_t tested;                       // Boxes tested last frame
+  int32_t visible;
+  int32_t culled;
+} CullingContext;
+ECS_COMPONENT_DECLARE(CullingContext);
+
+// Frustum from a raylib camera, same projection as BeginMode3D
+Frustum3D culling_frustum_from_camera(Camera3D camera, float aspect, float nearPlane, float farPlane);
+// Frustum planes from a view projection matrix (MatrixMultiply(view, proj))
+Frustum3D culling_frustum_from_matrix(Matrix viewProj);
+
+// World AABB of a local box under a world matrix
+void culling_world_bounds(const BoundingBox *local, const Matrix *world, WorldBounds3D *out);
+
+// Single box test
+bool culling_test_aabb(const Frustum3D *frustum, Vector3 center, Vector3 extents);
+
+// Batch test, stride is the byte distance between two elements of each array.
+// Writes visible (bool) per box and returns the visible count.
+int32_t culling_test_aabb_batch(const Frustum3D *frustum,
+  const Vector3 *centers, size_t centerStride,
+  const Vector3 *extents, size_t extentStride,
+  bool *visible, size_t visibleStride,
+  int32_t count);
+
+void flecs_culling_module_init(ecs_world_t *world);
+
+#endif
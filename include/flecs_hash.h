@@ -0,0 +1,32 @@
+#ifndef FLECS_HASH_H
+#define FLECS_HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// FNV-1a, the key of the name / asset indexes (ecs_map_t).
+// A hit is not a match, two names can share a hash: the indexes compare the
+// stored name on a hit.
+
+#define HASH_FNV1A_SEED 0xcbf29ce484222325ull
+
+static inline uint64_t hash_fnv1a(uint64_t h, const void *data, size_t size){
+  const unsigned char *p = data;
+  for (size_t i = 0; i < size; i++) {
+    h ^= p[i];
+    h *= 0x100000001b3ull;
+  }
+  return h;
+}
+
+// Of the first maxLen chars, the part of the name a fixed size field stores
+static inline uint64_t hash_fnv1a_str(const char *s, size_t maxLen){
+  uint64_t h = HASH_FNV1A_SEED;
+  for (size_t i = 0; s[i] && i < maxLen; i++) {
+    h ^= (unsigned char)s[i];
+    h *= 0x100000001b3ull;
+  }
+  return h;
+}
+
+#endif
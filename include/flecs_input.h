@@ -0,0 +1,177 @@
+#ifndef FLECS_INPUT_H
+#define FLECS_INPUT_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "flecs.h"
+#include "raylib.h"
+
+// Input snapshot per logic tick.
+// rl_input_system takes one per tick, live from raylib or from a replay
+// stream. Game systems read it (input_key_down & co) instead of raylib, logic
+// runs at a fixed step so a replayed run does the same work tick for tick,
+// with or without a window. Pressed / released are edges between two ticks.
+//
+// Stream: "RLIN", version, fixed step, then one record per tick holding only
+// what changed since the tick before (an idle tick is 1 byte).
+// RL_INPUT_RECORD=path records a run, RL_INPUT_REPLAY=path replays one.
+
+#define INPUT_KEY_COUNT 352                     // raylib key codes end at KEY_KB_MENU (348)
+#define INPUT_KEY_WORDS ((INPUT_KEY_COUNT + 63) / 64)
+#define INPUT_MOUSE_BUTTON_COUNT 7
+#define INPUT_QUEUE_SIZE 64                     // Key presses between two ticks
+#define INPUT_STREAM_VERSION 1
+
+typedef struct {
+  uint64_t keys[INPUT_KEY_WORDS];               // Down, one bit per key code
+  uint8_t mouseButtons;                         // Down, one bit per button
+  Vector2 mousePosition;
+  Vector2 mouseDelta;
+  float wheel;
+} InputSnapshot;
+
+typedef struct {
+  int16_t key;
+  bool isDown;                                  // Pressed, else released
+} InputKeyEvent;
+
+typedef enum {
+  INPUT_LIVE,
+  INPUT_RECORD,                                 // Live and written to recordFile
+  INPUT_REPLAY                                  // From replayData, raylib is not polled
+} InputMode;
+
+typedef struct {
+  InputSnapshot current;
+  InputSnapshot previous;
+  // edges of this tick, one xor / and pass over the words
+  uint64_t pressed[INPUT_KEY_WORDS];
+  uint64_t released[INPUT_KEY_WORDS];
+  // every key edge of this tick, presses in arrival order then releases
+  InputKeyEvent events[INPUT_QUEUE_SIZE];
+  int32_t eventCount;
+  // live presses drained from raylib since the last tick (input_pump)
+  int16_t queue[INPUT_QUEUE_SIZE];
+  int32_t queueCount;
+  // mouse motion of the frames since the last tick, taken by the next poll
+  Vector2 pendingDelta;
+  float pendingWheel;
+  int64_t pumpFrame;                            // Last frame added to pendingDelta
+  int64_t droppedEvents;                        // Queue or event list full
+  InputMode mode;
+  int64_t tick;                                 // Snapshots taken
+  FILE *recordFile;
+  int64_t recordBytes;
+  bool hasRecordHeader;                         // Written on the first tick, the step is known then
+  uint8_t *replayData;                          // Whole stream, records start after the header
+  int32_t replaySize;
+  int32_t replayPos;
+  float replayStep;                             // Fixed step of the recording
+  int64_t replayTicks;
+  bool isReplayDone;                            // Stream ended, back to live input
+  bool needsFullScan;                           // Next poll asks every key (start, replay ended)
+} InputState;
+ECS_COMPONENT_DECLARE(InputState);
+
+bool input_record_start(InputState *in, const char *path);
+bool input_replay_start(InputState *in, const char *path);
+// Closes the record file or drops the replay, back to live
+void input_stop(InputState *in);
+
+// Drains the raylib key queue (every press of the frame) and adds the mouse
+// delta / wheel of a new frame (SimulationClock.frames) once. Call before
+// each live tick and once per displayed frame, so frames without a logic
+// tick lose nothing and frames with several ticks count motion once.
+void input_pump(InputState *in, int64_t frame);
+// Next snapshot: replay record, else raylib when canPoll (there is a window),
+// else nothing down. step is the logic tick, written to / checked against the stream.
+// Live keys are the queued presses + the keys that were down and still are,
+// a key pressed and released between two ticks is down for one tick.
+void input_update(InputState *in, bool canPoll, float step);
+
+bool input_key_down(const InputState *in, int key);
+bool input_key_pressed(const InputState *in, int key);
+bool input_key_released(const InputState *in, int key);
+bool input_mouse_down(const InputState *in, int button);
+bool input_mouse_pressed(const InputState *in, int button);
+// Key edges of this tick in order, returns the count
+int32_t input_key_events(const InputState *in, const InputKeyEvent **events);
+Vector2 input_mouse_delta(const InputState *in);
+Vector2 input_mouse_position(const InputState *in);
+float input_mouse_wheel(const InputState *in);
+
+void input_print(const InputState *in);
+
+// Action map.
+// Bindings (key or mouse button -> action) are compiled into a table, one
+// action mask per key code, the resolve pass walks only the bound keys that
+// are down in the snapshot and ors their masks. Axes come from action pairs
+// and the mouse delta. rl_input_system resolves once per tick into
+// PlayerInput_T, systems read that instead of key codes.
+
+typedef enum {
+  ACTION_MOVE_FORWARD,
+  ACTION_MOVE_BACK,
+  ACTION_MOVE_LEFT,
+  ACTION_MOVE_RIGHT,
+  ACTION_MOVE_UP,
+  ACTION_MOVE_DOWN,
+  ACTION_JUMP,
+  ACTION_RESET,
+  ACTION_CAMERA_MODE,
+  ACTION_CAPTURE_MOUSE,
+  ACTION_RELEASE_MOUSE,
+  ACTION_COUNT
+} InputAction;
+#define INPUT_ACTION_BIT(a) (1u << (a))
+
+typedef enum {
+  INPUT_AXIS_MOVE_X,                            // Right - left
+  INPUT_AXIS_MOVE_Y,                            // Forward - back
+  INPUT_AXIS_MOVE_Z,                            // Up - down
+  INPUT_AXIS_LOOK_X,                            // Mouse delta, pixels
+  INPUT_AXIS_LOOK_Y,
+  INPUT_AXIS_COUNT
+} InputAxis;
+
+#define INPUT_MAX_BINDINGS 96
+
+typedef struct {
+  int16_t code;                                 // Key code, or mouse button when isMouse
+  bool isMouse;
+  uint8_t action;
+} InputBinding;
+
+typedef struct {
+  InputBinding bindings[INPUT_MAX_BINDINGS];
+  int32_t bindingCount;
+  // compiled from bindings (input_actions_compile)
+  uint32_t keyActions[INPUT_KEY_COUNT];
+  uint32_t buttonActions[INPUT_MOUSE_BUTTON_COUNT];
+  uint64_t boundKeys[INPUT_KEY_WORDS];          // Keys with any action
+} InputActionMap;
+ECS_COMPONENT_DECLARE(InputActionMap);
+
+// Resolved actions of one tick, INPUT_ACTION_BIT masks
+typedef struct {
+  uint32_t down;
+  uint32_t pressed;
+  uint32_t released;
+  float axes[INPUT_AXIS_COUNT];
+} InputActions;
+
+void input_actions_default(InputActionMap *map);
+// Bind / unbind recompile the table
+bool input_action_bind(InputActionMap *map, InputAction action, int code, bool isMouse);
+void input_action_unbind(InputActionMap *map, InputAction action);
+void input_actions_compile(InputActionMap *map);
+void input_actions_resolve(const InputActionMap *map, const InputState *in, InputActions *out);
+const char *input_action_name(InputAction action);
+// -1 when there is no action with that name
+int input_action_find(const char *name);
+void input_actions_print(const InputActionMap *map);
+
+// InputState + InputActionMap singletons, starts RL_INPUT_RECORD / RL_INPUT_REPLAY
+void flecs_input_module_init(ecs_world_t *world);
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef FLECS_JOBS_H
+#define FLECS_JOBS_H
+
+#include <stdint.h>
+#include "flecs.h"
+
+// Time sliced job queue.
+// Deferred main thread work (loads, scene building, unloads) is queued with a
+// priority and run once per displayed frame until the budget in microseconds
+// is used up. A job returns true when it is done, false to be called again in
+// a later slice, so long work can be split into steps. At least one slice
+// runs every frame, a single slice can still go over the budget.
+
+#define JOB_QUEUE_BUDGET_US 2000
+#define JOB_NAME_SIZE 32
+
+typedef enum {
+  JOB_PRIORITY_HIGH,
+  JOB_PRIORITY_NORMAL,
+  JOB_PRIORITY_LOW,
+  JOB_PRIORITY_COUNT
+} JobPriority;
+
+// true = done, false = run again later (goes behind jobs of the same priority)
+typedef bool (*JobCallback)(ecs_world_t *world, void *ctx);
+
+typedef struct {
+  JobCallback callback;
+  void *ctx;                            // Owned by the callback
+  JobPriority priority;
+  uint64_t seq;                         // FIFO inside a priority
+  int64_t queuedFrame;
+  bool isStarted;
+  char name[JOB_NAME_SIZE];
+} Job;
+
+typedef struct {
+  int64_t pushed;
+  int64_t completed;
+  int64_t slices;                       // Callback calls, a job can take many
+  int64_t dropped;                      // Still queued at job_queue_fini
+  int32_t lastSlices;                   // Last frame
+  float lastUs;
+  float maxSliceUs;
+  char maxSliceName[JOB_NAME_SIZE];
+  int64_t overBudgetFrames;
+  int64_t maxWaitFrames;                // Queued to first run
+  int32_t pendingByPriority[JOB_PRIORITY_COUNT];
+} JobQueueStats;
+
+typedef struct {
+  Job *heap;                            // Binary heap, priority then seq
+  int32_t count;
+  int32_t capacity;
+  uint64_t nextSeq;
+  int64_t frame;
+  int32_t budgetUs;
+  bool isClosed;                        // After job_queue_fini, push fails
+  JobQueueStats stats;
+} JobQueue;
+ECS_COMPONENT_DECLARE(JobQueue);
+
+// false when there is no queue (module not initialized or closed), run the work directly then
+bool job_queue_push(ecs_world_t *world, const char *name, JobPriority priority, JobCallback callback, void *ctx);
+void job_queue_set_budget(ecs_world_t *world, int32_t budgetUs);
+// One frame worth of slices, returns how many ran
+int32_t job_queue_run(JobQueue *q, ecs_world_t *world, int32_t budgetUs);
+void job_queue_print(const JobQueue *q);
+
+// Drops what is still queued, owners clean up on their own fini
+void job_queue_fini(ecs_world_t *world);
+void flecs_jobs_module_init(ecs_world_t *world);
+
+#endif
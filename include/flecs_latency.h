@@ -0,0 +1,79 @@
+#ifndef FLECS_LATENCY_H
+#define FLECS_LATENCY_H
+
+#include "flecs.h"
+
+// Input to display latency.
+// One record per logic tick that sampled input, keyed by the InputState tick
+// and carrying the displayed frame it ran in. rl_input_system opens the tick
+// record, the transform pass and the end of the tick stamp it, and
+// rl_end_render_system stamps the present after EndDrawing on every tick of
+// the frame. raylib polls input events inside EndDrawing, so the poll of a
+// frame is the present of the frame before (headless: the frame start, the
+// replay record is there already). The ring buffer gives p50/p95/p99/max.
+// Headless has no present, the simulation part (poll / sample -> transform,
+// simulated) is measured the same way. Tick counts and hasInput come from
+// the snapshot, so a headless replay counts what its recording counted.
+
+#define LATENCY_HISTORY 512
+
+typedef enum {
+  LATENCY_POLL,                                 // Events polled (previous EndDrawing)
+  LATENCY_SAMPLE,                               // rl_input_system of the tick
+  LATENCY_TRANSFORM,                            // Transform pass of the tick done
+  LATENCY_SIMULATED,                            // Logic tick done
+  LATENCY_PRESENT,                              // After EndDrawing of the tick's frame, 0 headless
+  LATENCY_STAGE_COUNT
+} LatencyStage;
+
+// From -> to stage pairs, ms
+typedef enum {
+  LATENCY_POLL_TO_PRESENT,                      // Input to present
+  LATENCY_SAMPLE_TO_PRESENT,
+  LATENCY_POLL_TO_SIMULATED,
+  LATENCY_SAMPLE_TO_TRANSFORM,
+  LATENCY_SAMPLE_TO_SIMULATED,
+  LATENCY_METRIC_COUNT
+} LatencyMetric;
+
+typedef struct {
+  int64_t tick;                                 // InputState tick of the sample
+  int64_t frameId;                              // Displayed frame the tick ran in
+  bool hasInput;                                // Key edge, mouse motion or wheel in the tick
+  uint64_t stamps[LATENCY_STAGE_COUNT];         // ecs_os_now, 0 = not reached
+} LatencyTick;
+
+typedef struct {
+  float p50;
+  float p95;
+  float p99;
+  float max;
+  int32_t count;                                // Ticks that had both stages
+} LatencySummary;
+
+typedef struct {
+  LatencyTick history[LATENCY_HISTORY];
+  int32_t head;                                 // Next write
+  int32_t count;                                // Valid ticks in history
+  int64_t ticks;                                // Ticks sampled since start (or reset)
+  int64_t inputTicks;                           // Of those, hasInput
+  int64_t frames;                               // Displayed frames, timing dependent
+  int64_t idleFrames;                           // No logic tick, input waits for the next frame
+} LatencyStats;
+
+// flecs_module_frame, around the whole frame
+void latency_frame_begin(void);
+void latency_frame_end(void);
+// rl_input_system, opens the record of this tick
+void latency_sample(int64_t tick, bool hasInput);
+// TRANSFORM / SIMULATED go to the open tick, PRESENT to every tick of the frame
+void latency_mark(LatencyStage stage);
+
+const LatencyStats *latency_stats(void);
+// inputOnly = ticks with input only
+LatencySummary latency_summary(LatencyMetric metric, bool inputOnly);
+const char *latency_metric_name(LatencyMetric metric);
+void latency_reset(void);
+void latency_print(void);
+
+#endif
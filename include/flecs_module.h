@@ -3,6 +3,11 @@
 
 #include "flecs.h"
 #include "raylib.h"
+#include "flecs_profiler.h"
+#include "flecs_trace.h"
+#include "flecs_jobs.h"
+#include "flecs_query_cache.h"
+#include "task_pool.h"
 
 typedef struct {
   char name[32]; // Fixed-size string for simplicity
@@ -16,6 +21,15 @@ typedef struct {
 } ModuleContext;
 ECS_COMPONENT_DECLARE(ModuleContext);
 
+// PluginModule entities by name, filled by add_module_name. pending counts
+// the modules not cleaned up yet, shutdown is done when it is back to 0.
+typedef struct {
+  ecs_map_t index;                      // FNV-1a of the name (next key on a clash) -> PluginModule entity
+  int32_t count;
+  int32_t pending;                      // ecs_os_ainc / ecs_os_adec
+} ModuleRegistry;
+ECS_COMPONENT_DECLARE(ModuleRegistry);
+
 typedef struct {
 ecs_entity_t OnSetUpPhase;
 ecs_entity_t OnSetupGraphicPhase;
@@ -26,6 +40,7 @@ ecs_entity_t LogicUpdatePhase;
 ecs_entity_t BeginRenderPhase;
 //only 3d model render and 2d will not work here.
 ecs_entity_t BeginCamera3DPhase;
+ecs_entity_t CullCamera3DPhase;   // cpu culling, no draw calls
 ecs_entity_t UpdateCamera3DPhase;
 ecs_entity_t EndCamera3DPhase;
 //only 2d render if 3d will not work here.
@@ -33,9 +48,34 @@ ecs_entity_t Render2D1Phase;
 ecs_entity_t Render2D2Phase;
 ecs_entity_t Render2D3Phase;
 ecs_entity_t EndRenderPhase;
+
+// BeginRenderPhase..EndRenderPhase carry RenderPhaseTag
+ecs_entity_t RenderPhaseTag;
+// fixed step, ecs_progress runs it (world pipeline)
+ecs_entity_t LogicPipeline;
+// once per displayed frame, ecs_run_pipeline
+ecs_entity_t RenderPipeline;
 } FlecsPhases;
 extern FlecsPhases GlobalPhases;
 
+// Fixed step clock, set by the main loop before the render pipeline runs
+typedef struct {
+  float fixedStep;                      // Seconds per logic tick
+  float accumulator;                    // Wall time not simulated yet
+  float alpha;                          // Time between the last tick and the next one, 0..1
+  int64_t ticks;                        // Logic ticks since start
+  int32_t ticksThisFrame;
+  int64_t frames;                       // Displayed frames started, flecs_module_frame
+  int32_t droppedTicks;                 // Ticks skipped by the per frame cap since start
+} SimulationClock;
+ECS_COMPONENT_DECLARE(SimulationClock);
+
+// Worker threads for the module systems, owned by the world (freed at fini)
+typedef struct {
+  TaskPool *pool;                       // NULL = everything runs on the main thread
+} TaskScheduler;
+ECS_COMPONENT_DECLARE(TaskScheduler);
+
 // shut down and clean up phase
 ecs_entity_t ShutDownEvent;
 ecs_entity_t ShutDownModule;
@@ -51,7 +91,18 @@ ecs_entity_t Widget;
 
 // init module
 void flecs_module_init(ecs_world_t *world);
+// Runs up to maxTicks logic ticks for the accumulated time, then the render
+// pipeline once. Returns the ticks run this frame.
+int32_t flecs_module_frame(ecs_world_t *world, float frameDelta, int32_t maxTicks);
+// Replaces the pool, 0 workers = no pool. Call from the main (window) thread.
+void flecs_module_set_task_workers(ecs_world_t *world, int32_t workers);
+// NULL when there is no scheduler, task_pool_* then run inline
+TaskPool *flecs_module_task_pool(const ecs_world_t *world);
+// Marks the module cleaned up, once, hashed lookup
 void module_break_name(ecs_iter_t *it, const char *module_name);
+// Registers a PluginModule, an existing name returns its entity
 ecs_entity_t add_module_name(ecs_world_t *world, const char *name);
+// 0 when there is no module with that name
+ecs_entity_t module_find(const ecs_world_t *world, const char *name);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,62 @@
+#ifndef FLECS_PROFILER_H
+#define FLECS_PROFILER_H
+
+#include <stdio.h>
+#include "flecs.h"
+
+// Per system profiler.
+// Systems registered with profiler_system_init get their callback wrapped in
+// a trampoline that times every call with ecs_os_now. Once per displayed
+// frame the totals go into a rolling history per system, summaries and
+// histograms are built from it on demand (overlay, console, dump).
+// Build without RL_PROFILER and profiler_system_init is ecs_system_init,
+// the rest compiles to nothing.
+
+#define PROFILER_HISTORY 128
+#define PROFILER_BUCKETS 16             // Histogram, bucket b = [2^(b-1), 2^b) us
+
+typedef struct {
+  float min;
+  float avg;
+  float p99;
+  float max;
+} ProfilerSummary;
+
+#ifdef RL_PROFILER
+
+// Variadic so the compound literal desc can be passed like to ecs_system_init
+#define profiler_system_init(world, ...) profiler_system_init_desc(world, __VA_ARGS__)
+ecs_entity_t profiler_system_init_desc(ecs_world_t *world, const ecs_system_desc_t *desc);
+// Same as ecs_observer, the callback shows up in trace captures (flecs_trace.h)
+#define profiler_observer(world, ...) profiler_observer_init(world, &(ecs_observer_desc_t) __VA_ARGS__ )
+ecs_entity_t profiler_observer_init(ecs_world_t *world, const ecs_observer_desc_t *desc);
+
+int32_t profiler_count(void);
+const char *profiler_name(int32_t index);
+const char *profiler_phase_name(int32_t index);
+// ms per frame over the history
+ProfilerSummary profiler_summary(int32_t index);
+void profiler_histogram(int32_t index, int32_t buckets[PROFILER_BUCKETS]);
+// Entry indices sorted by avg, slowest first, returns how many were written
+int32_t profiler_sorted(int32_t *out, int32_t max);
+
+void profiler_set_overlay(bool show);
+bool profiler_overlay(void);
+void profiler_reset(void);
+// Summary + histogram per system and per phase
+void profiler_print(void);
+bool profiler_dump(const char *path);
+
+void flecs_profiler_module_init(ecs_world_t *world);
+
+#else
+
+#define profiler_system_init(world, ...) ecs_system_init(world, __VA_ARGS__)
+#define profiler_observer(world, ...) ecs_observer_init(world, &(ecs_observer_desc_t) __VA_ARGS__ )
+static inline void profiler_print(void){}
+static inline bool profiler_dump(const char *path){ (void)path; return false; }
+static inline void flecs_profiler_module_init(ecs_world_t *world){ (void)world; }
+
+#endif
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef FLECS_QUERY_CACHE_H
+#define FLECS_QUERY_CACHE_H
+
+#include "flecs.h"
+
+// Named query cache.
+// Modules declare their ad hoc queries once (init), by name and query desc,
+// keep the handle and fetch the flecs query with query_cache_get. Queries
+// are cached (EcsQueryCacheAuto unless the desc says otherwise) and freed at
+// world fini. A second declare of the same name returns the first handle.
+// Debug (RL_QUERY_DEBUG=1 or `queries debug`) warns when a query is created
+// inside a running frame, that query belonged in the module init. Queries
+// kept outside the cache can opt in to the check with query_cache_init.
+
+#define QUERY_CACHE_MAX 64
+
+typedef int32_t QueryHandle;                    // Entry index + 1, 0 = none
+
+typedef struct {
+  char name[32];
+  ecs_query_t *query;
+  bool isLate;                                  // Created inside a frame
+} QueryCacheEntry;
+
+typedef struct {
+  QueryCacheEntry entries[QUERY_CACHE_MAX];
+  int32_t count;
+  ecs_map_t index;                              // FNV-1a of the name (next key on a clash) -> handle
+  bool isDebug;
+  int32_t lateCount;                            // Created inside a frame, cached or not
+  int32_t directCount;                          // query_cache_init, outside the cache
+} QueryCache;
+ECS_COMPONENT_DECLARE(QueryCache);
+
+QueryHandle query_cache_declare(ecs_world_t *world, const char *name, const ecs_query_desc_t *desc);
+// query_cache(world, "name", { .terms = {...} })
+#define query_cache(world, name, ...) query_cache_declare(world, name, &(ecs_query_desc_t) __VA_ARGS__)
+// 0 when nothing was declared with that name
+QueryHandle query_cache_find(const ecs_world_t *world, const char *name);
+// NULL for a bad handle
+ecs_query_t *query_cache_get(const ecs_world_t *world, QueryHandle handle);
+void query_cache_set_debug(ecs_world_t *world, bool isDebug);
+// ecs_query_init for a query the caller keeps: counted and warned about
+// when made inside a frame, like a declare. Plain ecs_query_init without
+// a QueryCache (benches).
+ecs_query_t *query_cache_init_(ecs_world_t *world, const ecs_query_desc_t *desc, const char *file, int32_t line);
+// query_cache_init(world, &(ecs_query_desc_t){ .terms = {...} })
+// (variadic, a compound literal desc has commas outside parentheses)
+#define query_cache_init(world, ...) query_cache_init_(world, __VA_ARGS__, __FILE__, __LINE__)
+void query_cache_print(const QueryCache *cache);
+
+// QueryCache singleton, before the modules that declare queries
+void flecs_query_cache_module_init(ecs_world_t *world);
+
+#endif
@@ -5,6 +5,9 @@
 #include "raylib.h"
 #include "raymath.h" // For quaternion and matrix operations
 #include "rlgl.h"    // For rlPushMatrix, rlTranslatef, etc.
+#include "render_batch.h"
+#include "flecs_assets.h"
+#include "flecs_input.h"
 
 typedef struct {
   Camera3D camera;
@@ -16,6 +19,8 @@ typedef struct {
   int height;
   bool isLoaded;
   bool isCaptureMouse;
+  bool isHeadless;                      // No window and no GL calls, logic and CPU render work still run
+  int32_t headlessFrames;               // Headless, logic ticks before shutdown (0 = until shouldQuit)
 } RayLibContext;
 ECS_COMPONENT_DECLARE(RayLibContext);
 
@@ -32,22 +37,59 @@ typedef struct {
 ECS_COMPONENT_DECLARE(CameraContext_T);
 
 // Transform3D component
+// Compatibility type, ecs_set(Transform3D) is split into the components below
+// and removed. Use transform3d_get/transform3d_set for full struct access.
 typedef struct {
   Vector3 position;                     // Local position
   Quaternion rotation;                  // Local rotation
   Vector3 scale;                        // Local scale
   Matrix localMatrix;                   // Local transform matrix
   Matrix worldMatrix;                   // World transform matrix
-  bool isDirty;                         // Flag to indicate if transform needs updating
+  bool isDirty;                         // Unused, changes are picked up by flecs change detection
 } Transform3D;
 ECS_COMPONENT_DECLARE(Transform3D);
 
-// Pointer component for raylib Model
+// Hot local TRS (40 bytes), written by gameplay and read by propagation.
+// Write it through an InOut system field, ecs_set or ecs_modified so the
+// table change is detected, read only systems should use EcsIn.
 typedef struct {
-  bool isLoaded;
-  Model model;
+  Vector3 position;                     // Local position
+  Quaternion rotation;                  // Local rotation
+  Vector3 scale;                        // Local scale
+} LocalTransform3D;
+ECS_COMPONENT_DECLARE(LocalTransform3D);
+
+// Cold cached world matrix (64 bytes), written by propagation and read by render
+typedef struct {
+  Matrix worldMatrix;                   // World transform matrix
+} WorldTransform3D;
+ECS_COMPONENT_DECLARE(WorldTransform3D);
+
+// Opt in, world matrix of the previous logic tick. Render blends it with
+// WorldTransform3D by SimulationClock.alpha
+typedef struct {
+  Matrix worldMatrix;
+} PreviousWorldTransform3D;
+ECS_COMPONENT_DECLARE(PreviousWorldTransform3D);
+
+// Handle into the AssetRegistry, the model itself is shared and refcounted.
+// The component holds its own reference (copy acquires, dtor releases).
+typedef struct {
+  ModelHandle handle;
 } ModelComponent;
 ECS_COMPONENT_DECLARE(ModelComponent);
+// Sets the component from a loader handle and gives the loader's reference back
+void rl_model_set(ecs_world_t *world, ecs_entity_t e, ModelHandle handle);
+
+// Draw state for the render queue
+typedef struct {
+  Color tint;
+  uint8_t layer;                        // Lower layers draw first (0-15)
+} MaterialComponent;
+ECS_COMPONENT_DECLARE(MaterialComponent);
+// Singleton render queue, rl_camera3d_system adds models, rl_render_batch_system draws them
+ECS_COMPONENT_DECLARE(RenderBatcher);
+
 // testing
 enum FSHAPE {
   FNONE,
@@ -102,8 +144,11 @@ typedef struct {
   float y;
 } ECS_RL_WHEEL_T;
 
+// key bits of the current tick, copied from InputState
 typedef struct {
-  ECS_RL_KEY_STATE_T keys[340];
+  uint64_t down[INPUT_KEY_WORDS];
+  uint64_t pressed[INPUT_KEY_WORDS];
+  uint64_t released[INPUT_KEY_WORDS];
   // ECS_SDL_MOUSE_T mouse;
   // SDL_Event event;
 } ECS_RL_INPUT_T;
@@ -118,6 +163,7 @@ typedef struct {
   bool Up;
   bool Down;
   bool isJump;
+  InputActions actions;                 // This tick, from InputActionMap (rl_input_system)
   float yaw;
   float pitch;
   float mouseSensitivity;
@@ -132,7 +178,7 @@ typedef struct {
 
 ECS_COMPONENT_DECLARE(Resize);
 
-bool is_model_valid(ModelComponent* component);
+bool is_model_valid(const Model* model);
 void flecs_raylib_module_init(ecs_world_t *world);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,78 @@
+#ifndef FLECS_RENDER_STATS_H
+#define FLECS_RENDER_STATS_H
+
+#include <stdio.h>
+#include "flecs_module.h"
+#include "flecs_raylib.h"
+
+// Per frame render counters.
+// Filled once per frame from RenderBatcher and CullingContext after the 3D
+// phases, kept in a ring buffer for min/avg/p99/max summaries. Optional
+// Render2D overlay, optional CSV dump (one row per frame).
+
+#define RENDER_STATS_HISTORY 256
+
+typedef struct {
+  float frameMs;                        // Wall clock, not the (fixed) ecs_progress step
+  int32_t drawCalls;
+  int32_t instances;
+  int32_t groups;
+  int32_t vertices;
+  int32_t triangles;
+  int32_t materialChanges;
+  int32_t tested;
+  int32_t visible;
+  int32_t culled;
+} RenderStatsFrame;
+
+// Fields of RenderStatsFrame for the summaries
+typedef enum {
+  RENDER_STAT_FRAME_MS,
+  RENDER_STAT_DRAW_CALLS,
+  RENDER_STAT_INSTANCES,
+  RENDER_STAT_GROUPS,
+  RENDER_STAT_VERTICES,
+  RENDER_STAT_TRIANGLES,
+  RENDER_STAT_MATERIAL_CHANGES,
+  RENDER_STAT_TESTED,
+  RENDER_STAT_VISIBLE,
+  RENDER_STAT_CULLED,
+  RENDER_STAT_COUNT
+} RenderStatField;
+
+typedef struct {
+  float min;
+  float avg;
+  float p99;
+  float max;
+} RenderStatSummary;
+
+typedef struct {
+  RenderStatsFrame last;                // Most recent frame
+  RenderStatsFrame history[RENDER_STATS_HISTORY];
+  int32_t head;                         // Next write
+  int32_t count;                        // Valid frames in history
+  int64_t frame;                        // Frames recorded since start
+  ecs_time_t frameTime;                 // Wall clock between two collects
+  bool showOverlay;
+  FILE *csv;                            // NULL = no dump
+} RenderStats;
+ECS_COMPONENT_DECLARE(RenderStats);
+
+const char *render_stats_field_name(RenderStatField field);
+float render_stats_value(const RenderStatsFrame *frame, RenderStatField field);
+
+// Push one frame into the ring buffer (and the CSV when open)
+void render_stats_record(RenderStats *stats, const RenderStatsFrame *frame);
+RenderStatSummary render_stats_summary(const RenderStats *stats, RenderStatField field);
+// Summary of every field through ecs_print
+void render_stats_print(const RenderStats *stats);
+
+// Header row is written on open, rows are flushed on close
+bool render_stats_csv_open(RenderStats *stats, const char *path);
+void render_stats_csv_close(RenderStats *stats);
+
+void render_stats_fini(ecs_world_t *world);
+void flecs_render_stats_module_init(ecs_world_t *world);
+
+#endif
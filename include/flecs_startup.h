@@ -0,0 +1,59 @@
+#ifndef FLECS_STARTUP_H
+#define FLECS_STARTUP_H
+
+#include "flecs.h"
+
+// Startup timing.
+// main marks each init step (startup_mark), marker systems registered last
+// in OnSetUpPhase..OnSetupWorldPhase time the setup chain of the first tick,
+// startup_first_frame closes it after the first rendered frame (time to first
+// frame, from startup_begin). Modules can move expensive resources out of
+// boot with StartupLazy, built on first use and reported in the same table.
+
+#define STARTUP_MAX_STAGES 32
+
+typedef void (*StartupLazyCallback)(ecs_world_t *world, void *ctx);
+
+typedef struct {
+  const char *name;
+  StartupLazyCallback init;
+  void *ctx;
+  bool isDone;
+} StartupLazy;
+
+typedef struct {
+  char name[40];
+  float ms;                                     // Step time, lazy: init time
+  float atMs;                                   // Since startup_begin, end of the step
+  bool isLazy;
+} StartupStage;
+
+typedef struct {
+  StartupStage stages[STARTUP_MAX_STAGES];
+  int32_t count;
+  uint64_t start;
+  uint64_t last;                                // Previous mark
+  float firstFrameMs;                           // 0 until the first frame
+  int32_t lazyPending;                          // Declared, not built yet
+} StartupStats;
+
+// Right after ecs_init (the os api clock comes with the world)
+void startup_begin(void);
+// Time since the previous mark goes to stage name
+void startup_mark(const char *name);
+// End of the first frame that ran the render pipeline, prints the table once
+void startup_first_frame(void);
+bool startup_is_done(void);
+
+// Declares a lazy resource, counted as pending until the first ensure
+void startup_lazy_declare(StartupLazy *lazy);
+// First call runs init and records its time, later calls return at once
+void startup_lazy_ensure(ecs_world_t *world, StartupLazy *lazy);
+
+const StartupStats *startup_stats(void);
+void startup_print(void);
+
+// Marker systems at the end of each setup phase, register after every other system
+void flecs_startup_module_init(ecs_world_t *world);
+
+#endif
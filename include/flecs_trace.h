@@ -0,0 +1,72 @@
+#ifndef FLECS_TRACE_H
+#define FLECS_TRACE_H
+
+#include <stdio.h>
+#include "flecs.h"
+
+// Timeline capture, Chrome trace event JSON (chrome://tracing, ui.perfetto.dev).
+// Begin / end events of frames, logic ticks, phases, systems and observers
+// (profiler trampolines) and user scopes. Every thread writes to its own
+// fixed size buffer, found by thread id, no lock on the hot path. trace_start
+// and trace_stop take effect at the next frame boundary so a capture only
+// holds whole frames. Build without RL_PROFILER and it compiles to nothing.
+
+#define TRACE_MAX_THREADS 32
+#define TRACE_BUFFER_EVENTS 65536               // Per thread, events past it are dropped
+
+typedef struct {
+  bool isCapturing;
+  int64_t frames;                               // Frames in the current / last capture
+  int64_t events;
+  int64_t dropped;                              // Buffer full
+  int32_t threads;                              // Threads that ever traced
+} TraceStats;
+
+#ifdef RL_PROFILER
+
+typedef struct {
+  const char *name;                             // Not copied, must outlive the capture
+  const char *cat;
+  uint64_t ts;                                  // ecs_os_now ns
+  char ph;                                      // 'B' or 'E'
+} TraceEvent;
+
+// name and cat must stay valid until the capture is written (literals, system names)
+void trace_begin(const char *name, const char *cat);
+void trace_end(void);
+
+// Main thread, profiler trampoline: closes the open phase when the phase changes
+void trace_phase_enter(ecs_entity_t phase, const char *name);
+// End of a pipeline run, closes the open phase
+void trace_phase_leave(void);
+
+// Frame boundary, flecs_module_frame: pending start / stop are applied here
+void trace_frame_begin(void);
+void trace_frame_end(void);
+
+void trace_start(void);
+// Stops at the end of the frame, then writes path (NULL = keep the buffers)
+void trace_stop(const char *path);
+bool trace_is_capturing(void);
+TraceStats trace_stats(void);
+// Writes what is buffered now, capturing or not
+bool trace_dump(const char *path);
+void trace_print(void);
+
+// TRACE_CAPTURE=path captures from the first frame, main writes it on exit
+void flecs_trace_module_init(ecs_world_t *world);
+
+#else
+
+static inline void trace_begin(const char *name, const char *cat){ (void)name; (void)cat; }
+static inline void trace_end(void){}
+static inline void trace_phase_leave(void){}
+static inline void trace_frame_begin(void){}
+static inline void trace_frame_end(void){}
+static inline bool trace_dump(const char *path){ (void)path; return false; }
+static inline void trace_print(void){}
+static inline void flecs_trace_module_init(ecs_world_t *world){ (void)world; }
+
+#endif
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef FLECS_TRANSFORM_H
+#define FLECS_TRANSFORM_H
+
+#include "flecs.h"
+#include "flecs_raylib.h"
+
+// Flat transform hierarchy cache.
+// Nodes are stored sorted by depth so a parent is always before its children,
+// world matrices are computed in one linear pass without any entity lookups.
+// The cache is only rebuilt when LocalTransform3D or ChildOf is added or removed.
+// Dirty nodes come from flecs change detection on LocalTransform3D tables,
+// when no table changed the whole pass is skipped.
+// With worker threads the nodes are sorted by (partition, depth), a partition is
+// a contiguous range of whole root subtrees so it never reads another range.
+typedef struct {
+  ecs_entity_t *entities;               // Node entity (depth order)
+  int32_t *parents;                     // Index of parent node, -1 for root, -2 parent has no transform
+  ecs_ref_t *localRefs;                 // Cached LocalTransform3D access per node
+  ecs_ref_t *worldRefs;                 // Cached WorldTransform3D access per node
+  bool *dirty;                          // LocalTransform3D table changed this frame
+  Matrix *world;                        // Last world matrix per node
+  bool *updated;                        // Node world matrix changed this pass
+  Vector3 *gatherPos;                   // TRS of non root nodes updated this pass
+  Quaternion *gatherRot;
+  Vector3 *gatherScale;
+  Matrix *gatherLocal;                  // Local matrices from the batch kernel
+  int32_t *gatherIndex;                 // Node index of each gathered entry
+  int32_t *partitionBegin;              // Node range per partition
+  int32_t *partitionEnd;
+  int32_t partitionCount;               // 1 = single thread
+  bool passFull;                        // isFullUpdate for the partitions of this frame
+  bool passActive;                      // Something changed, partitions have work
+  int32_t count;
+  int32_t capacity;
+  bool isDirty;                         // Hierarchy changed, rebuild on next update
+  bool isFullUpdate;                    // Recompute every node on next pass (after rebuild)
+  int rebuildCount;                     // Number of rebuilds (debug)
+  ecs_query_t *query;                   // All LocalTransform3D entities
+  ecs_query_t *rootQuery;               // Root tables, composed column by column
+  ecs_query_t *changeQuery;             // LocalTransform3D (In), change detection only
+  ecs_query_t *childQuery;              // Child tables, WorldTransform3D (Out) marked changed after a pass
+  ecs_map_t index;                      // Entity -> node index
+} TransformHierarchy;
+ECS_COMPONENT_DECLARE(TransformHierarchy);
+
+// One entity per partition, flecs splits them across the worker threads
+typedef struct {
+  int32_t index;
+} TransformPartition;
+ECS_COMPONENT_DECLARE(TransformPartition);
+
+void transform_hierarchy_init(ecs_world_t *world);
+void transform_hierarchy_rebuild(ecs_world_t *world, TransformHierarchy *th);
+void transform_hierarchy_propagate(ecs_world_t *world, TransformHierarchy *th);
+void transform_hierarchy_update(ecs_world_t *world);
+void transform_hierarchy_fini(ecs_world_t *world);
+
+// Node range [begin, end) of the depth sorted cache, roots must be composed first
+void transform_hierarchy_propagate_range(ecs_world_t *world, TransformHierarchy *th,
+  int32_t begin, int32_t end, bool full);
+
+// Update systems in the given phase. Rebuild and roots run on the main thread,
+// partitions run on the flecs worker threads.
+void transform_hierarchy_register_systems(ecs_world_t *world, ecs_entity_t phase);
+
+// Calls ecs_set_threads and splits root subtrees into one partition per thread.
+// threads <= 1 keeps everything on the main thread.
+void transform_hierarchy_set_threads(ecs_world_t *world, int32_t threads);
+
+// Local TRS to matrix, same order as raylib: scale * rotation * translation
+Matrix transform_local_matrix(const LocalTransform3D *local);
+
+// Compatibility accessors for code written against the full Transform3D
+bool transform3d_get(const ecs_world_t *world, ecs_entity_t entity, Transform3D *out);
+void transform3d_set(ecs_world_t *world, ecs_entity_t entity, const Transform3D *transform);
+
+#endif
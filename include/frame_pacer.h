@@ -0,0 +1,51 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <stdint.h>
+#include "flecs.h"
+
+// Wall clock frame pacing.
+// Monotonic nanosecond clock (flecs os api, ecs_os_now), frames are paced
+// against absolute deadlines so sleep error does not accumulate. Waiting is
+// an OS sleep until a safety margin before the deadline, then a spin. The
+// margin adapts to the measured sleep overshoot of the machine.
+
+typedef struct {
+  int32_t frames;                       // Frames in the window
+  float avgFrameMs;
+  float minFrameMs;
+  float maxFrameMs;
+  float jitterMs;                       // Standard deviation of the frame time
+  float maxErrorMs;                     // Worst |frame - target|
+  int32_t missed;                       // Frames later than target + 10%
+} FramePacerStats;
+
+typedef struct {
+  uint64_t targetNs;                    // 0 = uncapped
+  uint64_t deadline;                    // End of the current frame
+  uint64_t frameStart;
+  uint64_t spinNs;                      // Sleep stops this early, then spin
+  float maxDelta;                       // Cap of the returned delta (seconds)
+
+  // jitter window (Welford), reset by frame_pacer_stats_reset
+  int32_t frames;
+  double mean;
+  double m2;
+  double minNs;
+  double maxNs;
+  double maxErrorNs;
+  int32_t missed;
+} FramePacer;
+
+void frame_pacer_init(FramePacer *p, float targetHz);
+// 0 = uncapped, takes effect on the next frame
+void frame_pacer_set_target(FramePacer *p, float targetHz);
+// Start of a frame, returns the wall clock seconds since the previous frame start
+float frame_pacer_begin(FramePacer *p);
+// End of a frame, waits until the deadline
+void frame_pacer_wait(FramePacer *p);
+
+FramePacerStats frame_pacer_stats(const FramePacer *p);
+void frame_pacer_stats_reset(FramePacer *p);
+
+#endif
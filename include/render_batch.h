@@ -0,0 +1,100 @@
+#ifndef RENDER_BATCH_H
+#define RENDER_BATCH_H
+
+#include <stdint.h>
+#include "flecs.h"
+#include "raylib.h"
+
+// Sorted render queue with instanced batching.
+// Every add is a compact draw item with a 64 bit sort key, build radix sorts
+// the keys and cuts the sorted queue into groups of same layer, material,
+// tint and mesh. Each group is one DrawMeshInstanced call, groups are drawn
+// in key order so material changes are minimal and instances inside a group
+// go front to back. add/build are CPU only (no window needed), submit needs
+// the GL context.
+
+// Sort key, high to low: layer | material | mesh | depth
+#define RENDER_KEY_DEPTH_BITS 24
+#define RENDER_KEY_MESH_BITS 20
+#define RENDER_KEY_MATERIAL_BITS 16
+#define RENDER_KEY_LAYER_BITS 4
+
+#define RENDER_KEY_MESH_SHIFT RENDER_KEY_DEPTH_BITS
+#define RENDER_KEY_MATERIAL_SHIFT (RENDER_KEY_MESH_SHIFT + RENDER_KEY_MESH_BITS)
+#define RENDER_KEY_LAYER_SHIFT (RENDER_KEY_MATERIAL_SHIFT + RENDER_KEY_MATERIAL_BITS)
+
+// One queued draw, index points at the matrix in add order
+typedef struct {
+  uint64_t key;
+  int32_t index;
+} RenderQueueItem;
+
+// Material pointer + tint, the material part of the key
+typedef struct {
+  const Material *material;
+  Color tint;
+} RenderMaterialSlot;
+
+// One group = one draw call
+typedef struct {
+  uint64_t key;                         // Key without the depth bits
+  const Mesh *mesh;
+  const Material *material;
+  Color tint;
+  int32_t start;                        // First matrix in transforms (after build)
+  int32_t count;                        // Number of instances
+} RenderBatchGroup;
+
+typedef struct {
+  RenderBatchGroup *groups;             // In key order (after build)
+  int32_t groupCount;
+  int32_t groupCapacity;
+
+  // per frame ids for the key, reset by begin
+  const Mesh **meshes;
+  int32_t meshCount;
+  int32_t meshCapacity;
+  ecs_map_t meshIndex;                  // Pointer hash -> mesh id
+  RenderMaterialSlot *materials;
+  int32_t materialCount;
+  int32_t materialCapacity;
+  ecs_map_t materialIndex;              // Pointer + tint hash -> material id
+  int32_t lastMesh;                     // Cache, tables usually add the same mesh in a row
+  int32_t lastMaterial;
+
+  RenderQueueItem *items;               // Queue, sorted by build
+  RenderQueueItem *itemsTmp;            // Radix sort scratch
+  Matrix *matrices;                     // Added this frame, in add order
+  Matrix *transforms;                   // Sorted contiguous instance buffer (after build)
+  int32_t count;
+  int32_t capacity;
+
+  Shader shader;                        // Instancing shader, loaded on first submit
+  bool isShaderLoaded;
+  bool isInstancing;                    // false = fallback to one DrawMesh per instance
+
+  int32_t drawCalls;                    // Last submit
+  int32_t instances;
+  int32_t vertices;                     // Last build, all instances
+  int32_t triangles;
+  int32_t materialChanges;              // Groups where material or tint differs from the one before
+} RenderBatcher;
+
+void render_batch_init(RenderBatcher *b);
+void render_batch_fini(RenderBatcher *b);
+
+// Clear the queue and ids for a new frame
+void render_batch_begin(RenderBatcher *b);
+// depth is normalized 0..1 (0 = near), lower layers draw first
+void render_batch_add(RenderBatcher *b, const Mesh *mesh, const Material *material, Color tint,
+  uint8_t layer, float depth, const Matrix *transform);
+// Radix sort the queue and cut it into groups with contiguous transforms
+void render_batch_build(RenderBatcher *b);
+// One DrawMeshInstanced per group, wires = wireframe like DrawModelWires
+void render_batch_submit(RenderBatcher *b, bool wires);
+// drawCalls/instances like an instanced submit, no GL (headless)
+void render_batch_count(RenderBatcher *b);
+// Unload the shader, call before CloseWindow
+void render_batch_unload(RenderBatcher *b);
+
+#endif
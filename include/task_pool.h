@@ -0,0 +1,99 @@
+#ifndef TASK_POOL_H
+#define TASK_POOL_H
+
+#include <stdint.h>
+#include "flecs.h"
+
+// Work stealing task pool.
+// Threads, locks and atomics come from the flecs os api. Every thread has its
+// own deque, the owner pushes and pops at the tail (LIFO, cache warm), idle
+// threads steal from the head of the others (FIFO, the biggest pieces).
+// Slot 0 is the thread that called task_pool_init (the window thread), it
+// runs tasks while it waits in task_pool_wait. Tasks spawned with
+// task_pool_spawn_main only ever run there, use it for raylib/GL calls.
+// A NULL pool or 0 workers runs everything inline on the caller.
+
+#define TASK_POOL_MAX_WORKERS 63
+
+// worker is the deque slot of the running thread, 0 = main thread
+typedef void (*TaskCallback)(void *ctx, int32_t worker);
+// [begin, end) of a parallel for
+typedef void (*TaskRangeCallback)(void *ctx, int32_t begin, int32_t end, int32_t worker);
+
+// Fork join counter, zero initialize, wait on it with task_pool_wait
+typedef struct {
+  int32_t pending;
+} TaskGroup;
+
+typedef struct {
+  TaskCallback callback;
+  void *ctx;
+  TaskGroup *group;
+} Task;
+
+// Ring buffer, owner side is the tail
+typedef struct {
+  ecs_os_mutex_t lock;
+  Task *tasks;
+  int32_t head;
+  int32_t count;
+  int32_t capacity;
+} TaskDeque;
+
+// Written by the owning thread only
+typedef struct {
+  int64_t executed;
+  int64_t stolen;                       // Taken from another deque
+  int64_t sleeps;
+} TaskWorkerStats;
+
+typedef struct TaskPool TaskPool;
+
+typedef struct {
+  TaskPool *pool;
+  int32_t worker;
+} TaskWorkerStart;
+
+struct TaskPool {
+  int32_t workerCount;                  // Threads besides the main thread
+  TaskDeque *deques;                    // workerCount + 1, 0 = main
+  TaskDeque mainQueue;                  // Main thread affinity
+  TaskWorkerStats *stats;               // workerCount + 1
+  TaskWorkerStart *starts;
+  ecs_os_thread_t *threads;
+  ecs_os_thread_id_t *threadIds;        // workerCount + 1
+  ecs_os_mutex_t sleepLock;
+  ecs_os_cond_t wake;
+  int32_t queued;                       // Tasks in all deques (atomic)
+  int32_t started;                      // Workers that stored their thread id (atomic)
+  bool isStopping;
+};
+
+// workers = threads besides the caller, clamped to TASK_POOL_MAX_WORKERS
+void task_pool_init(TaskPool *p, int32_t workers);
+// Joins the workers, tasks still queued run on the caller
+void task_pool_fini(TaskPool *p);
+// Threads that run tasks, workers + main
+int32_t task_pool_threads(const TaskPool *p);
+
+void task_pool_spawn(TaskPool *p, TaskGroup *group, TaskCallback callback, void *ctx);
+// Queued for the main thread only (task_pool_wait on main, task_pool_run_main)
+void task_pool_spawn_main(TaskPool *p, TaskGroup *group, TaskCallback callback, void *ctx);
+// Runs tasks until the group is done, fork join
+void task_pool_wait(TaskPool *p, TaskGroup *group);
+// Poll instead of wait, true once every task of the group ran
+bool task_group_done(const TaskGroup *group);
+// Main thread tasks queued so far, returns how many ran
+int32_t task_pool_run_main(TaskPool *p);
+
+// Splits [0, count) into chunks of at least grain and waits for all of them
+void task_pool_parallel_for(TaskPool *p, int32_t count, int32_t grain, TaskRangeCallback callback, void *ctx);
+
+bool task_pool_is_main_thread(const TaskPool *p);
+// Deque slot of the calling thread, -1 for threads the pool does not know
+int32_t task_pool_worker_index(const TaskPool *p);
+
+void task_pool_stats_reset(TaskPool *p);
+void task_pool_print(const TaskPool *p);
+
+#endif
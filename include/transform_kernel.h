@@ -0,0 +1,37 @@
+#ifndef TRANSFORM_KERNEL_H
+#define TRANSFORM_KERNEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "raylib.h"
+
+// Batch TRS to matrix kernels.
+// Results are equal to the raymath path, up to the sign of zero,
+//   MatrixMultiply(MatrixScale(s), MatrixMultiply(QuaternionToMatrix(q), MatrixTranslate(p)))
+//   MatrixMultiply(left, right)
+// as long as the compiler does not contract mul+add into fma.
+// SSE2 handles 4 entities per step, AVX2 (build with /arch:AVX2 or -mavx2) 8.
+// Anything else falls back to scalar code.
+
+// Strided version, stride is the byte distance between two elements of each
+// array. Works on component columns, e.g. LocalTransform3D position/rotation/scale.
+void transform_compose_batch_strided(
+  const Vector3 *positions, size_t positionStride,
+  const Quaternion *rotations, size_t rotationStride,
+  const Vector3 *scales, size_t scaleStride,
+  Matrix *out, int32_t count);
+
+// Tightly packed arrays
+void transform_compose_batch(const Vector3 *positions, const Quaternion *rotations,
+  const Vector3 *scales, Matrix *out, int32_t count);
+
+// Scalar reference, used for the tail of a batch
+void transform_compose_scalar(Vector3 position, Quaternion rotation, Vector3 scale, Matrix *out);
+
+// out = MatrixMultiply(left, right), out may alias left or right
+void transform_matrix_multiply(const Matrix *left, const Matrix *right, Matrix *out);
+
+// Name of the active code path ("avx2", "sse2" or "scalar")
+const char *transform_kernel_name(void);
+
+#endif
@@ -0,0 +1,575 @@
+// refcounted model registry
+// key -> slot map, slots are reused through a free list and carry a
+// generation so an old handle never points at a newer model.
+#include <stdio.h>
+#include <string.h>
+#include "flecs_module.h"
+#include "flecs_assets.h"
+#include "flecs_jobs.h"
+#include "flecs_hash.h"
+
+static uint64_t asset_key_path(const char *path){
+  return hash_fnv1a(HASH_FNV1A_SEED, path, strlen(path));
+}
+
+static uint64_t asset_key_cube(float width, float height, float length){
+  float params[3] = { width, height, length };
+  uint64_t h = hash_fnv1a(HASH_FNV1A_SEED, "cube", 4);
+  return hash_fnv1a(h, params, sizeof(params));
+}
+
+static AssetEntry *asset_entry(const AssetRegistry *reg, ModelHandle handle){
+  if (!reg || reg->isClosed || handle.index == 0 || (int32_t)handle.index > reg->count) return NULL;
+  AssetEntry *e = &reg->entries[handle.index - 1];
+  if (!e->isLoaded || e->generation != handle.generation) return NULL;
+  return e;
+}
+
+// Drops the key of slot, unless a clash or a retry points it elsewhere
+static void asset_unindex(AssetRegistry *reg, int32_t slot){
+  uint64_t key = reg->entries[slot].key;
+  ecs_map_val_t *indexed = ecs_map_get(&reg->index, key);
+  if (indexed && *indexed == (ecs_map_val_t)slot) ecs_map_remove(&reg->index, key);
+}
+
+// Existing model with this key, one more reference. The key is a hash, the
+// name has to match too: a clash is a miss and the new model is not indexed.
+static bool asset_find(AssetRegistry *reg, uint64_t key, const char *name, ModelHandle *out){
+  ecs_map_val_t *slot = ecs_map_get(&reg->index, key);
+  if (!slot) return false;
+  AssetEntry *e = &reg->entries[*slot];
+  if (strncmp(e->name, name, sizeof(e->name) - 1) != 0) {
+    ecs_print(1, "[assets] %s and %s share a key, %s is not shared", e->name, name, name);
+    return false;
+  }
+  e->refCount++;
+  *out = (ModelHandle){ .index = (uint32_t)*slot + 1, .generation = e->generation };
+  return true;
+}
+
+// Pending slot for key, resident after asset_make_resident
+static int32_t asset_slot_alloc(AssetRegistry *reg, uint64_t key, const char *name){
+  int32_t slot;
+  if (reg->freeHead >= 0) {
+    slot = reg->freeHead;
+    reg->freeHead = reg->entries[slot].nextFree;
+  } else {
+    if (reg->count == reg->capacity) {
+      reg->capacity = reg->capacity ? reg->capacity * 2 : 32;
+      reg->entries = ecs_os_realloc_n(reg->entries, AssetEntry, reg->capacity);
+    }
+    slot = reg->count++;
+    reg->entries[slot] = (AssetEntry){0};
+  }
+
+  AssetEntry *e = &reg->entries[slot];
+  e->key = key;
+  e->model = (Model){0};
+  e->refCount = 1;
+  e->isLoaded = true;
+  e->isResident = false;
+  e->residentFrame = -1;
+  e->nextFree = -1;
+  strncpy(e->name, name, sizeof(e->name) - 1);
+  e->name[sizeof(e->name) - 1] = '\0';
+  // a clashing key keeps its first model
+  if (!ecs_map_get(&reg->index, key)) ecs_map_insert(&reg->index, key, (ecs_map_val_t)slot);
+  return slot;
+}
+
+static void asset_make_resident(AssetRegistry *reg, AssetEntry *e, Model model, int64_t frame){
+  e->model = model;
+  e->isResident = true;
+  e->residentFrame = frame;
+  reg->loaded++;
+  ecs_print(1, "[assets] loaded %s (%d unique)", e->name, reg->loaded);
+}
+
+static ModelHandle asset_add(AssetRegistry *reg, uint64_t key, const char *name, Model model){
+  if (model.meshCount <= 0 || !model.meshes) {
+    ecs_print(1, "[assets] failed to load %s", name);
+    return (ModelHandle){0};
+  }
+  int32_t slot = asset_slot_alloc(reg, key, name);
+  AssetEntry *e = &reg->entries[slot];
+  asset_make_resident(reg, e, model, -1);
+  return (ModelHandle){ .index = (uint32_t)slot + 1, .generation = e->generation };
+}
+
+// GenMeshCube without UploadMesh, same 24 vertices and 12 triangles.
+// UnloadModel is GL free for it, vaoId and vboId are never set
+static Mesh asset_gen_mesh_cube_cpu(float width, float height, float length){
+  static const float corners[4][2] = { {-1, -1}, {1, -1}, {1, 1}, {-1, 1} };
+  float half[3] = { width * 0.5f, height * 0.5f, length * 0.5f };
+  Mesh mesh = { .vertexCount = 24, .triangleCount = 12 };
+  mesh.vertices = RL_CALLOC(24 * 3, sizeof(float));
+  mesh.normals = RL_CALLOC(24 * 3, sizeof(float));
+  mesh.texcoords = RL_CALLOC(24 * 2, sizeof(float));
+  mesh.indices = RL_CALLOC(36, sizeof(unsigned short));
+
+  // face f: axis f/2, + or - side, the two other axes span the quad
+  for (int f = 0; f < 6; f++) {
+    int axis = f / 2;
+    int a1 = (axis + 1) % 3;
+    int a2 = (axis + 2) % 3;
+    float side = (f % 2) ? -1.0f : 1.0f;
+    for (int c = 0; c < 4; c++) {
+      int v = f * 4 + c;
+      // a1 flips on the - side so both sides wind counter clockwise from outside
+      mesh.vertices[v * 3 + axis] = side * half[axis];
+      mesh.vertices[v * 3 + a1] = corners[c][0] * side * half[a1];
+      mesh.vertices[v * 3 + a2] = corners[c][1] * half[a2];
+      mesh.normals[v * 3 + axis] = side;
+      mesh.texcoords[v * 2 + 0] = (corners[c][0] + 1.0f) * 0.5f;
+      mesh.texcoords[v * 2 + 1] = (corners[c][1] + 1.0f) * 0.5f;
+    }
+    static const unsigned short quad[6] = { 0, 1, 2, 0, 2, 3 };
+    for (int k = 0; k < 6; k++) {
+      mesh.indices[f * 6 + k] = (unsigned short)(f * 4 + quad[k]);
+    }
+  }
+  return mesh;
+}
+
+ModelHandle asset_model_load(ecs_world_t *world, const char *path){
+  AssetRegistry *reg = ecs_singleton_get_mut(world, AssetRegistry);
+  if (!reg || reg->isClosed || !path) return (ModelHandle){0};
+  uint64_t key = asset_key_path(path);
+  ModelHandle handle;
+  if (asset_find(reg, key, path, &handle)) return handle;
+  if (reg->isHeadless) {
+    ecs_print(1, "[assets] headless, skip %s", path);
+    return (ModelHandle){0};
+  }
+  return asset_add(reg, key, path, LoadModel(path));
+}
+
+ModelHandle asset_model_cube(ecs_world_t *world, float width, float height, float length){
+  AssetRegistry *reg = ecs_singleton_get_mut(world, AssetRegistry);
+  if (!reg || reg->isClosed) return (ModelHandle){0};
+  uint64_t key = asset_key_cube(width, height, length);
+  char name[64];
+  snprintf(name, sizeof(name), "cube %g %g %g", width, height, length);
+  ModelHandle handle;
+  if (asset_find(reg, key, name, &handle)) return handle;
+  Mesh mesh = reg->isHeadless ? asset_gen_mesh_cube_cpu(width, height, length) : GenMeshCube(width, height, length);
+  return asset_add(reg, key, name, LoadModelFromMesh(mesh));
+}
+
+//===============================================
+// ASYNC LOADS
+//===============================================
+static void asset_decode_task(void *ctx, int32_t worker){
+  (void)worker;
+  AssetLoad *load = ctx;
+  trace_begin("asset decode", "assets");
+  load->isDecoded = load->decode(load->ctx);
+  trace_end();
+}
+
+bool asset_load_async(ecs_world_t *world, const char *name, AssetDecodeCallback decode, AssetUploadCallback upload, void *ctx){
+  AssetRegistry *reg = ecs_singleton_get_mut(world, AssetRegistry);
+  if (!reg || reg->isClosed || !decode || !upload) return false;
+
+  AssetLoad *load = ecs_os_calloc_t(AssetLoad);
+  snprintf(load->name, sizeof(load->name), "%s", name ? name : "asset");
+  load->decode = decode;
+  load->upload = upload;
+  load->ctx = ctx;
+  load->queuedTime = ecs_os_now();
+  if (reg->loadCount == reg->loadCapacity) {
+    reg->loadCapacity = reg->loadCapacity ? reg->loadCapacity * 2 : 16;
+    reg->loads = ecs_os_realloc_n(reg->loads, AssetLoad *, reg->loadCapacity);
+  }
+  reg->loads[reg->loadCount++] = load;
+  reg->loadStats.queued++;
+
+  // no workers, the upload step decodes it (still under the budget)
+  TaskPool *pool = flecs_module_task_pool(world);
+  if (task_pool_threads(pool) > 1) {
+    load->isSpawned = true;
+    task_pool_spawn(pool, &load->group, asset_decode_task, load);
+  }
+  return true;
+}
+
+// Entry a load was started for, NULL when it was released meanwhile
+static AssetEntry *asset_pending_entry(AssetRegistry *reg, ModelHandle handle){
+  AssetEntry *e = asset_entry(reg, handle);
+  return e && !e->isResident ? e : NULL;
+}
+
+// Load of a pending entry failed: the key goes so the next load of the same
+// asset gets a new slot and tries again, the handles held now stay pending
+// (placeholder) until released
+static void asset_pending_failed(AssetRegistry *reg, AssetEntry *e){
+  asset_unindex(reg, (int32_t)(e - reg->entries));
+}
+
+typedef struct {
+  ModelHandle handle;
+  float size[3];
+  Mesh mesh;
+} AssetCubeLoad;
+
+static bool asset_cube_decode(void *ctx){
+  AssetCubeLoad *load = ctx;
+  load->mesh = asset_gen_mesh_cube_cpu(load->size[0], load->size[1], load->size[2]);
+  return load->mesh.vertices != NULL;
+}
+
+static AssetLoadStatus asset_cube_upload(ecs_world_t *world, void *ctx, AssetLoadStatus status){
+  AssetCubeLoad *load = ctx;
+  AssetRegistry *reg = ecs_singleton_get_mut(world, AssetRegistry);
+  AssetEntry *e = status != ASSET_LOAD_CANCELLED ? asset_pending_entry(reg, load->handle) : NULL;
+  AssetLoadStatus result = ASSET_LOAD_CANCELLED;
+  if (e && status == ASSET_LOAD_OK) {
+    if (!reg->isHeadless) UploadMesh(&load->mesh, false);
+    asset_make_resident(reg, e, LoadModelFromMesh(load->mesh), reg->uploadFrame);
+    result = ASSET_LOAD_OK;
+  } else {
+    // never uploaded, GL free
+    UnloadMesh(load->mesh);
+    if (e) {
+      asset_pending_failed(reg, e);
+      result = ASSET_LOAD_FAILED;
+    }
+  }
+  ecs_os_free(load);
+  return result;
+}
+
+ModelHandle asset_model_cube_async(ecs_world_t *world, float width, float height, float length){
+  AssetRegistry *reg = ecs_singleton_get_mut(world, AssetRegistry);
+  if (!reg || reg->isClosed) return (ModelHandle){0};
+  uint64_t key = asset_key_cube(width, height, length);
+  char name[64];
+  snprintf(name, sizeof(name), "cube %g %g %g", width, height, length);
+  ModelHandle handle;
+  if (asset_find(reg, key, name, &handle)) return handle;
+
+  int32_t slot = asset_slot_alloc(reg, key, name);
+  handle = (ModelHandle){ .index = (uint32_t)slot + 1, .generation = reg->entries[slot].generation };
+  AssetCubeLoad *load = ecs_os_calloc_t(AssetCubeLoad);
+  *load = (AssetCubeLoad){ .handle = handle, .size = { width, height, length } };
+  asset_load_async(world, name, asset_cube_decode, asset_cube_upload, load);
+  return handle;
+}
+
+typedef struct {
+  ModelHandle handle;
+  char *path;
+  unsigned char *data;                  // File bytes + NUL, RL_MALLOC, raylib frees it once handed over
+  int size;
+} AssetFileLoad;
+
+// raylib has no CPU only model parse (LoadModel parses, uploads the meshes and
+// loads the textures in one call). The worker reads the file into memory, the
+// upload step parses it from there: LoadModel gets the bytes through the file
+// load callbacks, so only the parse and the upload are on the main thread.
+// stdio instead of LoadFileData, its trace log would land in CustomLog off the
+// main thread
+static bool asset_file_decode(void *ctx){
+  AssetFileLoad *load = ctx;
+  FILE *f = fopen(load->path, "rb");
+  if (!f) return false;
+  fseek(f, 0, SEEK_END);
+  long size = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  // NUL terminated, text formats (OBJ) take the same buffer
+  unsigned char *data = size > 0 ? RL_MALLOC((size_t)size + 1) : NULL;
+  bool isRead = data && fread(data, 1, (size_t)size, f) == (size_t)size;
+  fclose(f);
+  if (!isRead) {
+    RL_FREE(data);
+    return false;
+  }
+  data[size] = 0;
+  load->data = data;
+  load->size = (int)size;
+  return true;
+}
+
+// load whose bytes LoadModel gets, main thread, only set inside asset_file_upload
+static AssetFileLoad *assetFileServed;
+
+static unsigned char *asset_file_serve_data(const char *fileName, int *dataSize){
+  AssetFileLoad *load = assetFileServed;
+  if (load && load->data && strcmp(fileName, load->path) == 0) {
+    unsigned char *data = load->data;
+    *dataSize = load->size;
+    load->data = NULL;
+    return data;
+  }
+  // the other files of the model (glTF buffers, textures) from disk
+  SetLoadFileDataCallback(NULL);
+  unsigned char *data = LoadFileData(fileName, dataSize);
+  SetLoadFileDataCallback(asset_file_serve_data);
+  return data;
+}
+
+static char *asset_file_serve_text(const char *fileName){
+  AssetFileLoad *load = assetFileServed;
+  if (load && load->data && strcmp(fileName, load->path) == 0) {
+    char *text = (char *)load->data;
+    load->data = NULL;
+    return text;
+  }
+  // .mtl of an OBJ from disk
+  SetLoadFileTextCallback(NULL);
+  char *text = LoadFileText(fileName);
+  SetLoadFileTextCallback(asset_file_serve_text);
+  return text;
+}
+
+static Model asset_file_parse(AssetFileLoad *load){
+  assetFileServed = load;
+  SetLoadFileDataCallback(asset_file_serve_data);
+  SetLoadFileTextCallback(asset_file_serve_text);
+  Model model = LoadModel(load->path);
+  SetLoadFileDataCallback(NULL);
+  SetLoadFileTextCallback(NULL);
+  assetFileServed = NULL;
+  return model;
+}
+
+static AssetLoadStatus asset_file_upload(ecs_world_t *world, void *ctx, AssetLoadStatus status){
+  AssetFileLoad *load = ctx;
+  AssetRegistry *reg = ecs_singleton_get_mut(world, AssetRegistry);
+  AssetEntry *e = status != ASSET_LOAD_CANCELLED ? asset_pending_entry(reg, load->handle) : NULL;
+  AssetLoadStatus result = ASSET_LOAD_CANCELLED;
+  if (e) {
+    Model model = status == ASSET_LOAD_OK ? asset_file_parse(load) : (Model){0};
+    if (model.meshCount > 0 && model.meshes) {
+      asset_make_resident(reg, e, model, reg->uploadFrame);
+      result = ASSET_LOAD_OK;
+    } else {
+      // a good read can still fail to parse, same as a failed decode.
+      // LoadModel gives a default material even then
+      if (model.meshCount <= 0) UnloadModel(model);
+      asset_pending_failed(reg, e);
+      result = ASSET_LOAD_FAILED;
+    }
+  }
+  // not handed to raylib (cancelled, failed, or the loader never asked)
+  RL_FREE(load->data);
+  ecs_os_free(load->path);
+  ecs_os_free(load);
+  return result;
+}
+
+ModelHandle asset_model_load_async(ecs_world_t *world, const char *path){
+  AssetRegistry *reg = ecs_singleton_get_mut(world, AssetRegistry);
+  if (!reg || reg->isClosed || !path) return (ModelHandle){0};
+  uint64_t key = asset_key_path(path);
+  ModelHandle handle;
+  if (asset_find(reg, key, path, &handle)) return handle;
+  if (reg->isHeadless) {
+    ecs_print(1, "[assets] headless, skip %s", path);
+    return (ModelHandle){0};
+  }
+
+  int32_t slot = asset_slot_alloc(reg, key, path);
+  handle = (ModelHandle){ .index = (uint32_t)slot + 1, .generation = reg->entries[slot].generation };
+  AssetFileLoad *load = ecs_os_calloc_t(AssetFileLoad);
+  *load = (AssetFileLoad){ .handle = handle, .path = ecs_os_strdup(path) };
+  asset_load_async(world, path, asset_file_decode, asset_file_upload, load);
+  return handle;
+}
+
+static void asset_placeholder_init(AssetRegistry *reg){
+  Mesh mesh = reg->isHeadless ? asset_gen_mesh_cube_cpu(1.0f, 1.0f, 1.0f) : GenMeshCube(1.0f, 1.0f, 1.0f);
+  reg->placeholder = LoadModelFromMesh(mesh);
+  reg->hasPlaceholder = true;
+}
+
+int32_t asset_upload_run(AssetRegistry *reg, ecs_world_t *world, int32_t budgetUs){
+  AssetLoadStats *s = &reg->loadStats;
+  reg->uploadFrame++;
+  s->lastUploads = 0;
+  s->lastUs = 0.0f;
+  if (reg->loadCount == 0) return 0;
+  // first load, main thread with a GL context
+  if (!reg->hasPlaceholder) asset_placeholder_init(reg);
+
+  uint64_t budgetNs = (uint64_t)budgetUs * 1000;
+  uint64_t start = ecs_os_now();
+  uint64_t elapsed = 0;
+  int32_t uploads = 0;
+  int32_t kept = 0;
+  // upload callbacks may queue more, those wait for the next frame
+  int32_t count = reg->loadCount;
+  for (int32_t i = 0; i < count; i++) {
+    AssetLoad *load = reg->loads[i];
+    // at least one upload so a small budget still makes progress
+    bool isOverBudget = uploads > 0 && elapsed >= budgetNs;
+    if (isOverBudget || (load->isSpawned && !task_group_done(&load->group))) {
+      reg->loads[kept++] = load;
+      continue;
+    }
+    trace_begin("asset upload", "assets");
+    if (!load->isSpawned) load->isDecoded = load->decode(load->ctx);
+    AssetLoadStatus result = load->upload(world, load->ctx, load->isDecoded ? ASSET_LOAD_OK : ASSET_LOAD_FAILED);
+    trace_end();
+
+    uint64_t now = ecs_os_now();
+    float latencyMs = (float)((double)(now - load->queuedTime) * 1e-6);
+    if (latencyMs > s->maxLatencyMs) s->maxLatencyMs = latencyMs;
+    if (result == ASSET_LOAD_OK) {
+      s->uploaded++;
+    } else if (result == ASSET_LOAD_FAILED) {
+      s->failed++;
+      ecs_print(1, "[assets] %s failed to %s, the next load retries", load->name, load->isDecoded ? "upload" : "decode");
+    }
+    ecs_os_free(load);
+    uploads++;
+    elapsed = now - start;
+  }
+  for (int32_t i = count; i < reg->loadCount; i++) {
+    reg->loads[kept++] = reg->loads[i];
+  }
+  reg->loadCount = kept;
+
+  s->lastUploads = uploads;
+  s->lastUs = (float)((double)elapsed * 1e-3);
+  if (elapsed > budgetNs) s->overBudgetFrames++;
+  return uploads;
+}
+
+void asset_set_upload_budget(ecs_world_t *world, int32_t budgetUs){
+  AssetRegistry *reg = ecs_singleton_get_mut(world, AssetRegistry);
+  if (!reg) return;
+  reg->uploadBudgetUs = budgetUs > 0 ? budgetUs : 0;
+}
+
+void asset_load_print(const AssetRegistry *reg){
+  if (!reg) return;
+  const AssetLoadStats *s = &reg->loadStats;
+  ecs_print(1, "assets, %d resident, %d loading, upload budget %d us", reg->loaded, reg->loadCount, reg->uploadBudgetUs);
+  ecs_print(1, "  queued %lld uploaded %lld failed %lld, max latency %.2f ms",
+    (long long)s->queued, (long long)s->uploaded, (long long)s->failed, s->maxLatencyMs);
+  ecs_print(1, "  last frame %d uploads %.1f us, over budget %lld frames",
+    s->lastUploads, s->lastUs, (long long)s->overBudgetFrames);
+}
+
+// before the draws, an upload this frame is drawn this frame
+void asset_upload_system(ecs_iter_t *it){
+  AssetRegistry *reg = ecs_singleton_get_mut(it->world, AssetRegistry);
+  if (!reg || reg->isClosed) return;
+  asset_upload_run(reg, it->world, reg->uploadBudgetUs);
+}
+
+void asset_register_systems(ecs_world_t *world){
+  profiler_system_init(world, &(ecs_system_desc_t){
+    .entity = ecs_entity(world, { .name = "asset_upload_system", .add = ecs_ids(ecs_dependson(GlobalPhases.BeginRenderPhase)) }),
+    .callback = asset_upload_system
+  });
+}
+
+//===============================================
+// HANDLES
+//===============================================
+ModelHandle asset_model_acquire(ecs_world_t *world, ModelHandle handle){
+  AssetEntry *e = asset_entry(ecs_singleton_get_mut(world, AssetRegistry), handle);
+  if (!e) return (ModelHandle){0};
+  e->refCount++;
+  return handle;
+}
+
+static void asset_unload_slot(AssetRegistry *reg, int32_t slot){
+  AssetEntry *e = &reg->entries[slot];
+  ecs_print(1, "[assets] unload %s", e->name);
+  // a pending slot has nothing yet, its upload sees the new generation
+  if (e->isResident) {
+    UnloadModel(e->model);
+    reg->loaded--;
+  }
+  e->isLoaded = false;
+  e->isResident = false;
+  e->nextFree = reg->freeHead;
+  reg->freeHead = slot;
+}
+
+// deferred unload, the slot is already unreachable (key removed, generation bumped)
+static bool asset_unload_job(ecs_world_t *world, void *ctx){
+  AssetRegistry *reg = ecs_singleton_get_mut(world, AssetRegistry);
+  // after fini everything is unloaded already
+  if (!reg || reg->isClosed) return true;
+  asset_unload_slot(reg, (int32_t)(intptr_t)ctx);
+  return true;
+}
+
+void asset_model_release(ecs_world_t *world, ModelHandle handle){
+  AssetRegistry *reg = ecs_singleton_get_mut(world, AssetRegistry);
+  AssetEntry *e = asset_entry(reg, handle);
+  if (!e) return;
+  if (--e->refCount > 0) return;
+
+  // stale for everyone now, the same key loads a new model
+  int32_t slot = (int32_t)(handle.index - 1);
+  asset_unindex(reg, slot);
+  e->generation++;
+  // the unload goes through the job queue so a mass despawn does not stall the frame
+  if (!job_queue_push(world, "asset unload", JOB_PRIORITY_LOW, asset_unload_job, (void *)(intptr_t)slot)) {
+    asset_unload_slot(reg, slot);
+  }
+}
+
+Model *asset_model_get(const ecs_world_t *world, ModelHandle handle){
+  AssetEntry *e = asset_entry(ecs_singleton_get(world, AssetRegistry), handle);
+  return e && e->isResident ? &e->model : NULL;
+}
+
+Model *asset_model_get_or_placeholder(const ecs_world_t *world, ModelHandle handle){
+  const AssetRegistry *reg = ecs_singleton_get(world, AssetRegistry);
+  AssetEntry *e = asset_entry(reg, handle);
+  if (!e) return NULL;
+  if (e->isResident) return &e->model;
+  return reg->hasPlaceholder ? (Model *)&reg->placeholder : NULL;
+}
+
+bool asset_model_is_fresh(const ecs_world_t *world, ModelHandle handle){
+  const AssetRegistry *reg = ecs_singleton_get(world, AssetRegistry);
+  AssetEntry *e = asset_entry(reg, handle);
+  return e && e->isResident && e->residentFrame == reg->uploadFrame;
+}
+
+void asset_registry_init(ecs_world_t *world){
+  ECS_COMPONENT_DEFINE(world, AssetRegistry);
+  AssetRegistry reg = { .freeHead = -1, .uploadBudgetUs = ASSET_UPLOAD_BUDGET_US };
+  ecs_map_init(&reg.index, NULL);
+  ecs_singleton_set_ptr(world, AssetRegistry, &reg);
+}
+
+void asset_registry_set_headless(ecs_world_t *world, bool headless){
+  AssetRegistry *reg = ecs_singleton_get_mut(world, AssetRegistry);
+  if (!reg) return;
+  reg->isHeadless = headless;
+}
+
+void asset_registry_fini(ecs_world_t *world){
+  AssetRegistry *reg = ecs_singleton_get_mut(world, AssetRegistry);
+  if (!reg || reg->isClosed) return;
+  // decodes in flight finish first, the cancel frees their CPU side
+  TaskPool *pool = flecs_module_task_pool(world);
+  for (int32_t i = 0; i < reg->loadCount; i++) {
+    AssetLoad *load = reg->loads[i];
+    if (load->isSpawned) task_pool_wait(pool, &load->group);
+    load->upload(world, load->ctx, ASSET_LOAD_CANCELLED);
+    ecs_os_free(load);
+  }
+  if (reg->loadCount > 0) {
+    ecs_print(1, "[assets] cancelled %d loads", reg->loadCount);
+  }
+  ecs_os_free(reg->loads);
+
+  for (int32_t i = 0; i < reg->count; i++) {
+    if (reg->entries[i].isLoaded && reg->entries[i].isResident) {
+      UnloadModel(reg->entries[i].model);
+    }
+  }
+  if (reg->hasPlaceholder) UnloadModel(reg->placeholder);
+  ecs_os_free(reg->entries);
+  ecs_map_fini(&reg->index);
+  *reg = (AssetRegistry){ .freeHead = -1, .isClosed = true };
+}
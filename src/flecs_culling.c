@@ -0,0 +1,271 @@
+// cpu frustum culling
+// world bounds from WorldTransform3D + mesh bounds, batch plane tests (SSE2)
+#include <math.h>
+#include "flecs_culling.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define CULLING_SSE
+#endif
+
+#ifndef RL_CULL_DISTANCE_NEAR
+  #define RL_CULL_DISTANCE_NEAR 0.01
+#endif
+#ifndef RL_CULL_DISTANCE_FAR
+  #define RL_CULL_DISTANCE_FAR 1000.0
+#endif
+// boxes per task pool chunk, below that one table runs on the calling thread
+#ifndef RL_CULL_GRAIN
+  #define RL_CULL_GRAIN 4096
+#endif
+
+// Element i of a strided array
+#define CULL_AT(type, base, stride, i) ((type *)((char *)(base) + (stride) * (size_t)(i)))
+
+static Vector4 culling_plane_normalize(Vector4 p){
+  float len = sqrtf(p.x*p.x + p.y*p.y + p.z*p.z);
+  if (len > 0.0f) {
+    p.x /= len; p.y /= len; p.z /= len; p.w /= len;
+  }
+  return p;
+}
+
+// Gribb/Hartmann, math row r of a raylib matrix is (m[r], m[r+4], m[r+8], m[r+12])
+Frustum3D culling_frustum_from_matrix(Matrix m){
+  Vector4 r0 = { m.m0, m.m4, m.m8, m.m12 };
+  Vector4 r1 = { m.m1, m.m5, m.m9, m.m13 };
+  Vector4 r2 = { m.m2, m.m6, m.m10, m.m14 };
+  Vector4 r3 = { m.m3, m.m7, m.m11, m.m15 };
+  Frustum3D f;
+  f.planes[0] = culling_plane_normalize((Vector4){ r3.x + r0.x, r3.y + r0.y, r3.z + r0.z, r3.w + r0.w }); // left
+  f.planes[1] = culling_plane_normalize((Vector4){ r3.x - r0.x, r3.y - r0.y, r3.z - r0.z, r3.w - r0.w }); // right
+  f.planes[2] = culling_plane_normalize((Vector4){ r3.x + r1.x, r3.y + r1.y, r3.z + r1.z, r3.w + r1.w }); // bottom
+  f.planes[3] = culling_plane_normalize((Vector4){ r3.x - r1.x, r3.y - r1.y, r3.z - r1.z, r3.w - r1.w }); // top
+  f.planes[4] = culling_plane_normalize((Vector4){ r3.x + r2.x, r3.y + r2.y, r3.z + r2.z, r3.w + r2.w }); // near
+  f.planes[5] = culling_plane_normalize((Vector4){ r3.x - r2.x, r3.y - r2.y, r3.z - r2.z, r3.w - r2.w }); // far
+  return f;
+}
+
+// Same view and projection BeginMode3D sets up
+Frustum3D culling_frustum_from_camera(Camera3D camera, float aspect, float nearPlane, float farPlane){
+  Matrix view = MatrixLookAt(camera.position, camera.target, camera.up);
+  Matrix proj;
+  if (camera.projection == CAMERA_ORTHOGRAPHIC) {
+    double top = camera.fovy / 2.0;
+    double right = top * aspect;
+    proj = MatrixOrtho(-right, right, -top, top, nearPlane, farPlane);
+  } else {
+    proj = MatrixPerspective(camera.fovy * DEG2RAD, aspect, nearPlane, farPlane);
+  }
+  return culling_frustum_from_matrix(MatrixMultiply(view, proj));
+}
+
+// Arvo: transform the center, extents by the absolute 3x3
+void culling_world_bounds(const BoundingBox *local, const Matrix *m, WorldBounds3D *out){
+  Vector3 c = Vector3Scale(Vector3Add(local->min, local->max), 0.5f);
+  Vector3 e = Vector3Scale(Vector3Subtract(local->max, local->min), 0.5f);
+  out->center = Vector3Transform(c, *m);
+  out->extents = (Vector3){
+    fabsf(m->m0)*e.x + fabsf(m->m4)*e.y + fabsf(m->m8)*e.z,
+    fabsf(m->m1)*e.x + fabsf(m->m5)*e.y + fabsf(m->m9)*e.z,
+    fabsf(m->m2)*e.x + fabsf(m->m6)*e.y + fabsf(m->m10)*e.z
+  };
+}
+
+// Outside when the box is fully behind any plane
+bool culling_test_aabb(const Frustum3D *f, Vector3 c, Vector3 e){
+  for (int p = 0; p < 6; p++) {
+    Vector4 pl = f->planes[p];
+    float d = pl.x*c.x + pl.y*c.y + pl.z*c.z + pl.w;
+    float r = fabsf(pl.x)*e.x + fabsf(pl.y)*e.y + fabsf(pl.z)*e.z;
+    if (d + r < 0.0f) return false;
+  }
+  return true;
+}
+
+int32_t culling_test_aabb_batch(const Frustum3D *f,
+  const Vector3 *centers, size_t centerStride,
+  const Vector3 *extents, size_t extentStride,
+  bool *visible, size_t visibleStride,
+  int32_t count){
+  int32_t visibleCount = 0;
+  int32_t i = 0;
+#if defined(CULLING_SSE)
+  __m128 nx[6], ny[6], nz[6], nw[6], ax[6], ay[6], az[6];
+  const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+  const __m128 zero = _mm_setzero_ps();
+  for (int p = 0; p < 6; p++) {
+    nx[p] = _mm_set1_ps(f->planes[p].x);
+    ny[p] = _mm_set1_ps(f->planes[p].y);
+    nz[p] = _mm_set1_ps(f->planes[p].z);
+    nw[p] = _mm_set1_ps(f->planes[p].w);
+    ax[p] = _mm_and_ps(nx[p], absMask);
+    ay[p] = _mm_and_ps(ny[p], absMask);
+    az[p] = _mm_and_ps(nz[p], absMask);
+  }
+  for (; i + 4 <= count; i += 4) {
+    const Vector3 *c0 = CULL_AT(const Vector3, centers, centerStride, i);
+    const Vector3 *c1 = CULL_AT(const Vector3, centers, centerStride, i + 1);
+    const Vector3 *c2 = CULL_AT(const Vector3, centers, centerStride, i + 2);
+    const Vector3 *c3 = CULL_AT(const Vector3, centers, centerStride, i + 3);
+    const Vector3 *e0 = CULL_AT(const Vector3, extents, extentStride, i);
+    const Vector3 *e1 = CULL_AT(const Vector3, extents, extentStride, i + 1);
+    const Vector3 *e2 = CULL_AT(const Vector3, extents, extentStride, i + 2);
+    const Vector3 *e3 = CULL_AT(const Vector3, extents, extentStride, i + 3);
+    __m128 cx = _mm_setr_ps(c0->x, c1->x, c2->x, c3->x);
+    __m128 cy = _mm_setr_ps(c0->y, c1->y, c2->y, c3->y);
+    __m128 cz = _mm_setr_ps(c0->z, c1->z, c2->z, c3->z);
+    __m128 ex = _mm_setr_ps(e0->x, e1->x, e2->x, e3->x);
+    __m128 ey = _mm_setr_ps(e0->y, e1->y, e2->y, e3->y);
+    __m128 ez = _mm_setr_ps(e0->z, e1->z, e2->z, e3->z);
+
+    __m128 outside = zero;
+    for (int p = 0; p < 6; p++) {
+      __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx[p], cx), _mm_mul_ps(ny[p], cy)),
+        _mm_add_ps(_mm_mul_ps(nz[p], cz), nw[p]));
+      __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax[p], ex), _mm_mul_ps(ay[p], ey)),
+        _mm_mul_ps(az[p], ez));
+      outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(d, r), zero));
+    }
+    int mask = _mm_movemask_ps(outside);
+    for (int k = 0; k < 4; k++) {
+      bool v = !(mask & (1 << k));
+      *CULL_AT(bool, visible, visibleStride, i + k) = v;
+      visibleCount += v;
+    }
+  }
+#endif
+  for (; i < count; i++) {
+    bool v = culling_test_aabb(f,
+      *CULL_AT(const Vector3, centers, centerStride, i),
+      *CULL_AT(const Vector3, extents, extentStride, i));
+    *CULL_AT(bool, visible, visibleStride, i) = v;
+    visibleCount += v;
+  }
+  return visibleCount;
+}
+
+// mesh bounds without model.transform, the world matrix is applied per frame
+static BoundingBox culling_model_bounds(const Model *model){
+  BoundingBox bounds = GetMeshBoundingBox(model->meshes[0]);
+  for (int i = 1; i < model->meshCount; i++) {
+    BoundingBox b = GetMeshBoundingBox(model->meshes[i]);
+    bounds.min = Vector3Min(bounds.min, b.min);
+    bounds.max = Vector3Max(bounds.max, b.max);
+  }
+  return bounds;
+}
+
+void culling_model_set_observer(ecs_iter_t *it){
+  ModelComponent *m = ecs_field(it, ModelComponent, 0);
+  for (int i = 0; i < it->count; i++) {
+    const Model *model = asset_model_get(it->world, m[i].handle);
+    if (!model || model->meshCount <= 0 || !model->meshes) continue;
+    ecs_set(it->world, it->entities[i], LocalBounds3D, { .box = culling_model_bounds(model) });
+  }
+}
+
+// frustum and counters once per frame
+void culling_begin_system(ecs_iter_t *it){
+  RayLibContext *rl_ctx = ecs_singleton_ensure(it->world, RayLibContext);
+  if (!rl_ctx || !rl_ctx->isCameraValid) return;
+  CullingContext *cull = ecs_singleton_ensure(it->world, CullingContext);
+  if (!cull) return;
+
+  float aspect = rl_ctx->height > 0 ? (float)rl_ctx->width / (float)rl_ctx->height : 1.0f;
+  cull->frustum = culling_frustum_from_camera(rl_ctx->camera, aspect,
+    (float)RL_CULL_DISTANCE_NEAR, (float)RL_CULL_DISTANCE_FAR);
+  cull->tested = 0;
+  cull->visible = 0;
+  cull->culled = 0;
+}
+
+typedef struct {
+  const CullingContext *cull;
+  const LocalBounds3D *lb;
+  const WorldTransform3D *t;
+  WorldBounds3D *wb;
+  int32_t visible[TASK_POOL_MAX_WORKERS + 1];   // per worker, no sharing
+} CullingJob;
+
+static void culling_range(void *ctx, int32_t begin, int32_t end, int32_t worker){
+  CullingJob *job = ctx;
+  WorldBounds3D *wb = job->wb;
+  for (int32_t i = begin; i < end; i++) {
+    culling_world_bounds(&job->lb[i].box, &job->t[i].worldMatrix, &wb[i]);
+  }
+
+  int32_t visible = end - begin;
+  if (job->cull->isEnabled) {
+    visible = culling_test_aabb_batch(&job->cull->frustum,
+      &wb[begin].center, sizeof(WorldBounds3D),
+      &wb[begin].extents, sizeof(WorldBounds3D),
+      &wb[begin].isVisible, sizeof(WorldBounds3D),
+      end - begin);
+  } else {
+    for (int32_t i = begin; i < end; i++) wb[i].isVisible = true;
+  }
+  job->visible[worker] += visible;
+}
+
+// update world bounds then test the whole table column, big tables are split
+// over the task pool
+void culling_system(ecs_iter_t *it){
+  CullingContext *cull = ecs_singleton_get_mut(it->world, CullingContext);
+  if (!cull) return;
+
+  CullingJob job = {
+    .cull = cull,
+    .lb = ecs_field(it, LocalBounds3D, 0),
+    .t = ecs_field(it, WorldTransform3D, 1),
+    .wb = ecs_field(it, WorldBounds3D, 2)
+  };
+  TaskPool *pool = flecs_module_task_pool(it->world);
+  task_pool_parallel_for(pool, it->count, RL_CULL_GRAIN, culling_range, &job);
+
+  int32_t visible = 0;
+  for (int32_t w = 0; w < task_pool_threads(pool); w++) visible += job.visible[w];
+  cull->tested += it->count;
+  cull->visible += visible;
+  cull->culled += it->count - visible;
+}
+
+void culling_register_components(ecs_world_t *world){
+  ECS_COMPONENT_DEFINE(world, LocalBounds3D);
+  ECS_COMPONENT_DEFINE(world, WorldBounds3D);
+  ECS_COMPONENT_DEFINE(world, CullingContext);
+}
+
+void culling_register_systems(ecs_world_t *world){
+  // LocalBounds3D always comes with the world bounds
+  ecs_add_pair(world, ecs_id(LocalBounds3D), EcsWith, ecs_id(WorldBounds3D));
+
+  profiler_observer(world, {
+    .entity = ecs_entity(world, { .name = "culling_model_set_observer" }),
+    .query.terms = {{ .id = ecs_id(ModelComponent) }},
+    .events = { EcsOnSet },
+    .callback = culling_model_set_observer
+  });
+
+  profiler_system_init(world, &(ecs_system_desc_t){
+    .entity = ecs_entity(world, { .name = "culling_begin_system", .add = ecs_ids(ecs_dependson(GlobalPhases.CullCamera3DPhase)) }),
+    .callback = culling_begin_system
+  });
+
+  profiler_system_init(world, &(ecs_system_desc_t){
+    .entity = ecs_entity(world, { .name = "culling_system", .add = ecs_ids(ecs_dependson(GlobalPhases.CullCamera3DPhase)) }),
+    .query.terms = {
+      { .id = ecs_id(LocalBounds3D), .inout = EcsIn },
+      { .id = ecs_id(WorldTransform3D), .inout = EcsIn },
+      { .id = ecs_id(WorldBounds3D), .inout = EcsOut }
+    },
+    .callback = culling_system
+  });
+}
+
+void flecs_culling_module_init(ecs_world_t *world){
+  ecs_print(1, "Initializing culling module...");
+  culling_register_components(world);
+  culling_register_systems(world);
+  ecs_singleton_set(world, CullingContext, { .isEnabled = true });
+}
@@ -10,6 +10,10 @@
 #include <stdarg.h>
 #include <string.h>
 #include "flecs_dk_console.h"
+#include "flecs_render_stats.h"
+#include "flecs_input.h"
+#include "flecs_startup.h"
+#include "flecs_latency.h"
 
 #define DK_CONSOLE_EXT_COMMAND_IMPLEMENTATION
 #include "dk_command.h"
@@ -366,24 +370,23 @@ void setpos(const char* argv){
   CustomLog(LOG_INFO, argv, NULL);
 }
 
-void reset(const char* argv){
-  if(c_world){
-    ecs_query_t *q = ecs_query(c_world, {
-      .terms = {
-        { .id = ecs_id(Transform3D) },
-      }
-    });
+// LocalTransform3D, declared at module init
+static QueryHandle resetQuery;
 
+void reset(const char* argv){
+  ecs_query_t *q = c_world ? query_cache_get(c_world, resetQuery) : NULL;
+  if(q){
     ecs_iter_t s_it = ecs_query_iter(c_world, q);
 
     while (ecs_query_next(&s_it)) {
-      Transform3D *p = ecs_field(&s_it, Transform3D, 0);
+      LocalTransform3D *p = ecs_field(&s_it, LocalTransform3D, 0);
       for (int i = 0; i < s_it.count; i ++) {
         // const char *name = ecs_get_name(c_world, s_it->entities[i]);
         const char *name = ecs_get_name(c_world, s_it.entities[i]);
-        if (strcmp(name, "PlayerNode") == 0) {
+        if (name && strcmp(name, "PlayerNode") == 0) {
           p[i].position = (Vector3){0,0,0};
-          p[i].isDirty = true;
+          // change detection, transform propagation picks up the table
+          ecs_modified(c_world, s_it.entities[i], LocalTransform3D);
         }
       }
     }
@@ -419,7 +422,305 @@ void resize(const char* argv){
   CustomLog(LOG_INFO, argv, NULL);
 }
 
+// stats = summary, stats overlay = toggle overlay, stats csv <path> / stats csv = start / stop dump
+void stats(const char* argv){
+  if(!c_world) return;
+  RenderStats *rs = ecs_singleton_get_mut(c_world, RenderStats);
+  if(!rs) return;
+
+  if (argv == NULL || strlen(argv) == 0) {
+    for (int f = 0; f < RENDER_STAT_COUNT; f++) {
+      RenderStatSummary s = render_stats_summary(rs, (RenderStatField)f);
+      CustomLog(LOG_INFO, TextFormat("%s min %.2f avg %.2f p99 %.2f max %.2f",
+        render_stats_field_name((RenderStatField)f), s.min, s.avg, s.p99, s.max), NULL);
+    }
+  } else if (strcmp(argv, "overlay") == 0) {
+    rs->showOverlay = !rs->showOverlay;
+    CustomLog(LOG_INFO, TextFormat("stats overlay %s", rs->showOverlay ? "on" : "off"), NULL);
+  } else if (strncmp(argv, "csv", 3) == 0) {
+    const char *path = argv + 3;
+    while (*path == ' ') { path++; }
+    if (strlen(path) > 0) {
+      CustomLog(render_stats_csv_open(rs, path) ? LOG_INFO : LOG_ERROR, TextFormat("stats csv %s", path), NULL);
+    } else {
+      render_stats_csv_close(rs);
+      CustomLog(LOG_INFO, "stats csv closed", NULL);
+    }
+  } else {
+    CustomLog(LOG_ERROR, TextFormat("stats: unknown option `%s`", argv), NULL);
+  }
+}
+
+// prof = summary, prof overlay = toggle overlay, prof reset, prof dump <path>
+void prof(const char* argv){
+#ifdef RL_PROFILER
+  if (argv == NULL || strlen(argv) == 0) {
+    int32_t order[16];
+    int32_t n = profiler_sorted(order, 16);
+    for (int32_t k = 0; k < n; k++) {
+      ProfilerSummary s = profiler_summary(order[k]);
+      CustomLog(LOG_INFO, TextFormat("%s [%s] avg %.3f p99 %.3f max %.3f ms",
+        profiler_name(order[k]), profiler_phase_name(order[k]), s.avg, s.p99, s.max), NULL);
+    }
+  } else if (strcmp(argv, "overlay") == 0) {
+    profiler_set_overlay(!profiler_overlay());
+    CustomLog(LOG_INFO, TextFormat("profiler overlay %s", profiler_overlay() ? "on" : "off"), NULL);
+  } else if (strcmp(argv, "reset") == 0) {
+    profiler_reset();
+    CustomLog(LOG_INFO, "profiler reset", NULL);
+  } else if (strncmp(argv, "dump", 4) == 0) {
+    const char *path = argv + 4;
+    while (*path == ' ') { path++; }
+    if (strlen(path) == 0) path = "profiler.csv";
+    CustomLog(profiler_dump(path) ? LOG_INFO : LOG_ERROR, TextFormat("profiler dump %s", path), NULL);
+  } else {
+    CustomLog(LOG_ERROR, TextFormat("prof: unknown option `%s`", argv), NULL);
+  }
+#else
+  CustomLog(LOG_WARNING, "profiler disabled, build with RL_PROFILER", NULL);
+#endif
+}
+
+// trace = capture status, trace start, trace stop [path], trace dump <path>
+void trace(const char* argv){
+#ifdef RL_PROFILER
+  if (argv == NULL || strlen(argv) == 0) {
+    TraceStats s = trace_stats();
+    CustomLog(LOG_INFO, TextFormat("trace %s, %lld frames, %lld events on %d threads, %lld dropped",
+      s.isCapturing ? "capturing" : "idle", (long long)s.frames, (long long)s.events, s.threads,
+      (long long)s.dropped), NULL);
+  } else if (strcmp(argv, "start") == 0) {
+    trace_start();
+    CustomLog(LOG_INFO, "trace starts next frame", NULL);
+  } else if (strncmp(argv, "stop", 4) == 0) {
+    const char *path = argv + 4;
+    while (*path == ' ') { path++; }
+    if (strlen(path) == 0) path = "trace.json";
+    trace_stop(path);
+    CustomLog(LOG_INFO, TextFormat("trace stops at the end of the frame, writes %s", path), NULL);
+  } else if (strncmp(argv, "dump", 4) == 0) {
+    const char *path = argv + 4;
+    while (*path == ' ') { path++; }
+    if (strlen(path) == 0) path = "trace.json";
+    CustomLog(trace_dump(path) ? LOG_INFO : LOG_ERROR, TextFormat("trace dump %s", path), NULL);
+  } else {
+    CustomLog(LOG_ERROR, TextFormat("trace: unknown option `%s`", argv), NULL);
+  }
+#else
+  CustomLog(LOG_WARNING, "trace disabled, build with RL_PROFILER", NULL);
+#endif
+}
+
+// jobs = queue stats, jobs budget <us> = per frame budget
+void jobs(const char* argv){
+  JobQueue *q = ecs_singleton_get_mut(c_world, JobQueue);
+  if (!q) return;
+  if (argv == NULL || strlen(argv) == 0) {
+    const JobQueueStats *s = &q->stats;
+    CustomLog(LOG_INFO, TextFormat("jobs pending %d budget %d us last %d slices %.1f us",
+      q->count, q->budgetUs, s->lastSlices, s->lastUs), NULL);
+    CustomLog(LOG_INFO, TextFormat("pushed %lld completed %lld over budget %lld frames max slice %.1f us (%s)",
+      (long long)s->pushed, (long long)s->completed, (long long)s->overBudgetFrames, s->maxSliceUs,
+      s->maxSliceName[0] ? s->maxSliceName : "-"), NULL);
+  } else if (strncmp(argv, "budget", 6) == 0) {
+    int budget = atoi(argv + 6);
+    job_queue_set_budget(c_world, budget);
+    CustomLog(LOG_INFO, TextFormat("jobs budget %d us", q->budgetUs), NULL);
+  } else {
+    CustomLog(LOG_ERROR, TextFormat("jobs: unknown option `%s`", argv), NULL);
+  }
+}
+
+// assets = async load stats, assets budget <us> = per frame upload budget
+void assets(const char* argv){
+  AssetRegistry *reg = ecs_singleton_get_mut(c_world, AssetRegistry);
+  if (!reg) return;
+  if (argv == NULL || strlen(argv) == 0) {
+    const AssetLoadStats *s = &reg->loadStats;
+    CustomLog(LOG_INFO, TextFormat("assets resident %d loading %d budget %d us last %d uploads %.1f us",
+      reg->loaded, reg->loadCount, reg->uploadBudgetUs, s->lastUploads, s->lastUs), NULL);
+    CustomLog(LOG_INFO, TextFormat("queued %lld uploaded %lld failed %lld max latency %.2f ms over budget %lld frames",
+      (long long)s->queued, (long long)s->uploaded, (long long)s->failed, s->maxLatencyMs,
+      (long long)s->overBudgetFrames), NULL);
+  } else if (strncmp(argv, "budget", 6) == 0) {
+    asset_set_upload_budget(c_world, atoi(argv + 6));
+    CustomLog(LOG_INFO, TextFormat("assets budget %d us", reg->uploadBudgetUs), NULL);
+  } else {
+    CustomLog(LOG_ERROR, TextFormat("assets: unknown option `%s`", argv), NULL);
+  }
+}
+
+// tasks = per thread counters, tasks reset, tasks threads <n> = worker threads
+void tasks(const char* argv){
+  TaskPool *pool = flecs_module_task_pool(c_world);
+  if (argv == NULL || strlen(argv) == 0) {
+    if (!pool) {
+      CustomLog(LOG_INFO, "tasks: no worker threads, everything runs on the main thread", NULL);
+      return;
+    }
+    for (int32_t i = 0; i < task_pool_threads(pool); i++) {
+      const TaskWorkerStats *s = &pool->stats[i];
+      CustomLog(LOG_INFO, TextFormat("%s %d executed %lld stolen %lld sleeps %lld", i == 0 ? "main" : "worker", i,
+        (long long)s->executed, (long long)s->stolen, (long long)s->sleeps), NULL);
+    }
+  } else if (strncmp(argv, "reset", 5) == 0) {
+    task_pool_stats_reset(pool);
+    CustomLog(LOG_INFO, "tasks reset", NULL);
+  } else if (strncmp(argv, "threads", 7) == 0) {
+    int workers = atoi(argv + 7);
+    flecs_module_set_task_workers(c_world, workers);
+    CustomLog(LOG_INFO, TextFormat("tasks %d worker threads", workers > 0 ? workers : 0), NULL);
+  } else {
+    CustomLog(LOG_ERROR, TextFormat("tasks: unknown option `%s`", argv), NULL);
+  }
+}
+
+// input = mode and tick, input record <path>, input replay <path>, input stop
+void input(const char* argv){
+  InputState *in = ecs_singleton_get_mut(c_world, InputState);
+  if (!in) return;
+  if (argv == NULL || strlen(argv) == 0) {
+    static const char *modes[] = { "live", "record", "replay" };
+    CustomLog(LOG_INFO, TextFormat("input %s tick %lld recorded %lld bytes replay %d / %d bytes",
+      modes[in->mode], (long long)in->tick, (long long)in->recordBytes, in->replayPos, in->replaySize), NULL);
+  } else if (strncmp(argv, "record", 6) == 0) {
+    const char *path = argv + 6;
+    while (*path == ' ') { path++; }
+    if (strlen(path) == 0) path = "input.rlin";
+    CustomLog(input_record_start(in, path) ? LOG_INFO : LOG_ERROR, TextFormat("input record %s", path), NULL);
+  } else if (strncmp(argv, "replay", 6) == 0) {
+    const char *path = argv + 6;
+    while (*path == ' ') { path++; }
+    if (strlen(path) == 0) path = "input.rlin";
+    CustomLog(input_replay_start(in, path) ? LOG_INFO : LOG_ERROR, TextFormat("input replay %s", path), NULL);
+  } else if (strcmp(argv, "stop") == 0) {
+    input_stop(in);
+    CustomLog(LOG_INFO, "input live", NULL);
+  } else {
+    CustomLog(LOG_ERROR, TextFormat("input: unknown option `%s`", argv), NULL);
+  }
+}
+
+// bind = actions and their keys, bind <action> <key code> | mouse<button> | none
+// (key_bind, bind is taken by libc)
+void key_bind(const char* argv){
+  InputActionMap *map = ecs_singleton_get_mut(c_world, InputActionMap);
+  if (!map) return;
+  if (argv == NULL || strlen(argv) == 0) {
+    input_actions_print(map);
+    CustomLog(LOG_INFO, TextFormat("%d bindings, list in the log", map->bindingCount), NULL);
+    return;
+  }
+  char name[32];
+  char code[16];
+  if (sscanf(argv, "%31s %15s", name, code) != 2) {
+    CustomLog(LOG_ERROR, "bind <action> <key code> | mouse<button> | none", NULL);
+    return;
+  }
+  int action = input_action_find(name);
+  if (action < 0) {
+    CustomLog(LOG_ERROR, TextFormat("bind: unknown action `%s`", name), NULL);
+    return;
+  }
+  if (strcmp(code, "none") == 0) {
+    input_action_unbind(map, (InputAction)action);
+    CustomLog(LOG_INFO, TextFormat("%s unbound", name), NULL);
+    return;
+  }
+  bool isMouse = strncmp(code, "mouse", 5) == 0;
+  const char *digits = isMouse ? code + 5 : code;
+  char *end = NULL;
+  long value = strtol(digits, &end, 10);
+  // whole string a number: "space" or a bare "mouse" is not key 0
+  if (end == digits || *end != '\0' || (!isMouse && value == 0)) {
+    CustomLog(LOG_ERROR, TextFormat("bind: `%s` is not a key code (1..%d) or mouse<0..%d>", code, INPUT_KEY_COUNT - 1, INPUT_MOUSE_BUTTON_COUNT - 1), NULL);
+    return;
+  }
+  if (!input_action_bind(map, (InputAction)action, (int)value, isMouse)) {
+    CustomLog(LOG_ERROR, TextFormat("bind: can't bind %s to %s", name, code), NULL);
+    return;
+  }
+  CustomLog(LOG_INFO, TextFormat("%s + %s", name, code), NULL);
+}
+
+// latency = input to present percentiles, latency reset
+void latency(const char* argv){
+  if (argv != NULL && strcmp(argv, "reset") == 0) {
+    latency_reset();
+    CustomLog(LOG_INFO, "latency reset", NULL);
+    return;
+  }
+  const LatencyStats *ls = latency_stats();
+  CustomLog(LOG_INFO, TextFormat("latency %lld ticks, %lld with input | %lld frames, %lld without a tick",
+    (long long)ls->ticks, (long long)ls->inputTicks, (long long)ls->frames, (long long)ls->idleFrames), NULL);
+  for (int m = 0; m < LATENCY_METRIC_COUNT; m++) {
+    LatencySummary s = latency_summary((LatencyMetric)m, false);
+    if (s.count == 0) continue;
+    CustomLog(LOG_INFO, TextFormat("%s p50 %.2f p95 %.2f p99 %.2f max %.2f ms",
+      latency_metric_name((LatencyMetric)m), s.p50, s.p95, s.p99, s.max), NULL);
+  }
+}
+
+// queries = cached named queries, queries debug (warn on queries made in a frame)
+void queries(const char* argv){
+  if (argv != NULL && strcmp(argv, "debug") == 0) {
+    const QueryCache *cache = ecs_singleton_get(c_world, QueryCache);
+    bool isDebug = cache && !cache->isDebug;
+    query_cache_set_debug(c_world, isDebug);
+    CustomLog(LOG_INFO, TextFormat("queries debug %s", isDebug ? "on" : "off"), NULL);
+    return;
+  }
+  const QueryCache *cache = ecs_singleton_get(c_world, QueryCache);
+  if (!cache) return;
+  CustomLog(LOG_INFO, TextFormat("queries %d, %d created inside a frame, debug %s",
+    cache->count, cache->lateCount, cache->isDebug ? "on" : "off"), NULL);
+  for (int32_t i = 0; i < cache->count; i++) {
+    CustomLog(LOG_INFO, TextFormat("%d %s%s", i + 1, cache->entries[i].name, cache->entries[i].isLate ? " (in frame)" : ""), NULL);
+  }
+}
+
+// startup = init step times, lazy resources and time to first frame
+void startup(const char* argv){
+  (void)argv;
+  const StartupStats *st = startup_stats();
+  CustomLog(LOG_INFO, TextFormat("time to first frame %.3f ms, %d lazy pending", st->firstFrameMs, st->lazyPending), NULL);
+  for (int32_t i = 0; i < st->count; i++) {
+    const StartupStage *s = &st->stages[i];
+    CustomLog(LOG_INFO, TextFormat("%s%s %.3f ms at %.3f ms", s->isLazy ? "lazy " : "", s->name, s->ms, s->atMs), NULL);
+  }
+}
+
+// command table, built by the first command instead of at boot
+static void dk_console_commands_init(ecs_world_t *world, void *ctx){
+  (void)world;
+  (void)ctx;
+  ecs_print(1, "DK_ExtCommandInit");
+  DK_ExtCommandInit();
+  DK_ExtCommandPush("echo", 1, "Prints a provided message in the console `echo Hello World`", &echo);
+  DK_ExtCommandPush("feco", 1, "flecs test", &feco);
+  DK_ExtCommandPush("clear", 0, "Clears the console buffer", &clear);
+  DK_ExtCommandPush("help", 1, "Shows the available commands and/or specific one `help <command_name>`", &help);
+
+  DK_ExtCommandPush("reset", 1, "flecs reset position player node", &reset);
+  DK_ExtCommandPush("pos", 1, "flecs set position player node", &setpos);
+  DK_ExtCommandPush("resize", 1, "flecs resize test", &resize);
+  DK_ExtCommandPush("prof", 1, "system profiler `prof`, `prof overlay`, `prof reset`, `prof dump <path>`", &prof);
+  DK_ExtCommandPush("trace", 1, "timeline capture, chrome trace json `trace`, `trace start`, `trace stop [path]`, `trace dump <path>`", &trace);
+  DK_ExtCommandPush("jobs", 1, "deferred job queue `jobs`, `jobs budget <us>`", &jobs);
+  DK_ExtCommandPush("assets", 1, "async asset loads `assets`, `assets budget <us>`", &assets);
+  DK_ExtCommandPush("bind", 1, "action keys `bind`, `bind <action> <key code>`, `bind <action> mouse<n>`, `bind <action> none`", &key_bind);
+  DK_ExtCommandPush("input", 1, "input record / replay `input`, `input record <path>`, `input replay <path>`, `input stop`", &input);
+  DK_ExtCommandPush("tasks", 1, "task pool threads `tasks`, `tasks reset`, `tasks threads <n>`", &tasks);
+  DK_ExtCommandPush("stats", 1, "render stats summary `stats`, `stats overlay`, `stats csv <path>`", &stats);
+  DK_ExtCommandPush("latency", 1, "input to present latency `latency`, `latency reset`", &latency);
+  DK_ExtCommandPush("queries", 1, "cached queries `queries`, `queries debug`", &queries);
+  DK_ExtCommandPush("startup", 1, "startup step times and time to first frame `startup`", &startup);
+}
+
+static StartupLazy dkCommandsLazy = { .name = "console commands", .init = dk_console_commands_init };
+
 void console_handler(const char* command){
+  startup_lazy_ensure(c_world, &dkCommandsLazy);
 
   char* command_buff = (char*)malloc(strlen(command) + 1);
   strcpy(command_buff, command);
@@ -442,34 +743,99 @@ void console_handler(const char* command){
   free(message_buff);
 }
 
+// Static font to persist
+static Font customFont;
+
+// same glyph set as LoadFont
+#define DK_CONSOLE_FONT_PATH "resources/font/Kenney Pixel.ttf"
+#define DK_CONSOLE_FONT_SIZE 32
+#define DK_CONSOLE_FONT_GLYPHS 95
+#define DK_CONSOLE_FONT_PADDING 4
+
+typedef struct {
+  Font font;
+  Image atlas;
+} DKConsoleFontLoad;
+
+// worker thread: file read, glyph rasterizing and atlas packing. stdio instead
+// of LoadFileData, its trace log would land in CustomLog off the main thread
+static bool dk_console_font_decode(void *ctx){
+  DKConsoleFontLoad *load = ctx;
+  FILE *f = fopen(DK_CONSOLE_FONT_PATH, "rb");
+  if (!f) return false;
+  fseek(f, 0, SEEK_END);
+  long size = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  unsigned char *data = size > 0 ? RL_MALLOC((size_t)size) : NULL;
+  bool isRead = data && fread(data, 1, (size_t)size, f) == (size_t)size;
+  fclose(f);
+  if (!isRead) {
+    RL_FREE(data);
+    return false;
+  }
+
+  load->font.baseSize = DK_CONSOLE_FONT_SIZE;
+  load->font.glyphCount = DK_CONSOLE_FONT_GLYPHS;
+  load->font.glyphPadding = DK_CONSOLE_FONT_PADDING;
+  load->font.glyphs = LoadFontData(data, (int)size, DK_CONSOLE_FONT_SIZE, NULL, DK_CONSOLE_FONT_GLYPHS, FONT_DEFAULT);
+  RL_FREE(data);
+  if (!load->font.glyphs) return false;
+  load->atlas = GenImageFontAtlas(load->font.glyphs, &load->font.recs, DK_CONSOLE_FONT_GLYPHS,
+    DK_CONSOLE_FONT_SIZE, DK_CONSOLE_FONT_PADDING, 0);
+  return load->atlas.data != NULL;
+}
+
+// main thread: atlas texture upload, then the console switches font
+static AssetLoadStatus dk_console_font_upload(ecs_world_t *world, void *ctx, AssetLoadStatus status){
+  DKConsoleFontLoad *load = ctx;
+  if (status == ASSET_LOAD_OK) {
+    load->font.texture = LoadTextureFromImage(load->atlas);
+    SetTextureFilter(load->font.texture, TEXTURE_FILTER_BILINEAR);
+    ecs_print(1, "Font texture ID: %u", load->font.texture.id);
+    customFont = load->font;
+  } else {
+    if (status == ASSET_LOAD_FAILED) ecs_print(1, "Failed to load font, falling back to default");
+    if (load->font.glyphs) UnloadFontData(load->font.glyphs, load->font.glyphCount);
+    RL_FREE(load->font.recs);
+  }
+  if (load->atlas.data) UnloadImage(load->atlas);
+  ecs_os_free(load);
+  return status;
+}
+
+// custom font, loaded when the console is first opened, default font until then
+static void dk_console_font_init(ecs_world_t *world, void *ctx){
+  (void)ctx;
+  DKConsoleFontLoad *fontLoad = ecs_os_calloc_t(DKConsoleFontLoad);
+  if (!asset_load_async(world, "console font", dk_console_font_decode, dk_console_font_upload, fontLoad)) {
+    dk_console_font_upload(world, fontLoad, dk_console_font_decode(fontLoad) ? ASSET_LOAD_OK : ASSET_LOAD_FAILED);
+  }
+}
+
+static StartupLazy dkFontLazy = { .name = "console font", .init = dk_console_font_init };
+
 void flecs_dk_console_setup_system(ecs_iter_t *it) {
   ecs_print(1, "flecs_dk_console_setup_system");
   SetTraceLogCallback(CustomLog);
-  ecs_print(1, "DK_ExtCommandInit");
-  DK_ExtCommandInit();
-  DK_ExtCommandPush("echo", 1, "Prints a provided message in the console `echo Hello World`", &echo);
-  DK_ExtCommandPush("feco", 1, "flecs test", &feco);
-  DK_ExtCommandPush("clear", 0, "Clears the console buffer", &clear);
-  DK_ExtCommandPush("help", 1, "Shows the available commands and/or specific one `help <command_name>`", &help);
-
-  DK_ExtCommandPush("reset", 1, "flecs reset position player node", &reset);
-  DK_ExtCommandPush("pos", 1, "flecs set position player node", &setpos);
-  DK_ExtCommandPush("resize", 1, "flecs resize test", &resize);
+  startup_lazy_declare(&dkCommandsLazy);
 
   console_global_ptr = &console;
   DK_ConsoleInit(console_global_ptr, LOG_SIZE);
   c_world = it->world;
 
-  // Static font to persist
-  static Font customFont;
-  const char* fontPath = "resources/font/Kenney Pixel.ttf";
-  customFont = LoadFont(fontPath);
-  if (customFont.texture.id == 0) {
-    ecs_print(1, "Failed to load font, falling back to default");
-    customFont = GetFontDefault();
+  // headless, commands and logs only, no font texture and no drawing
+  const RayLibContext *rl_ctx = ecs_singleton_get(it->world, RayLibContext);
+  if (rl_ctx && rl_ctx->isHeadless) {
+    ecs_singleton_set(it->world, DKConsoleContext, {
+      .console = console_global_ptr,
+      .isLoaded = false,
+    });
+    return;
   }
-  SetTextureFilter(customFont.texture, TEXTURE_FILTER_BILINEAR);
-  ecs_print(1, "Font texture ID: %u", customFont.texture.id);
+
+  // default font until the console is opened, imui keeps the pointer
+  customFont = GetFontDefault();
+  startup_lazy_declare(&dkFontLazy);
 
   ecs_singleton_set(it->world, DKConsoleContext, {
     .imui = {
@@ -498,6 +864,7 @@ void render2d_dk_console_system(ecs_iter_t *it){
   
   // Update console (pass the stored ImUI and console)
   DK_ConsoleUpdate(dc_ctx->console, &dc_ctx->imui, console_handler);
+  if (dc_ctx->console->is_open) startup_lazy_ensure(it->world, &dkFontLazy);
 
 }
 
@@ -518,7 +885,7 @@ void flecs_dk_console_cleanup_system(ecs_iter_t *it) {
   // ecs_print(1,"flecs_dk_console_cleanup_system");
   // if (dc_ctx && dc_ctx->isLoaded) {
     DK_ConsoleShutdown(dc_ctx->console, LOG_SIZE);
-    UnloadFont(*dc_ctx->imui.font);
+    if (dc_ctx->imui.font) UnloadFont(*dc_ctx->imui.font);
     // dc_ctx->isLoaded = false;
   // }
 
@@ -540,7 +907,7 @@ void flecs_dk_console_cleanup_event_system(ecs_iter_t *it) {
 
 void dk_console_register_systems(ecs_world_t *world){
 
-  ecs_system_init(world, &(ecs_system_desc_t){
+  profiler_system_init(world, &(ecs_system_desc_t){
     .entity = ecs_entity(world, { 
         .name = "flecs_dk_console_setup_system", 
         .add = ecs_ids(ecs_dependson(GlobalPhases.OnSetupModulePhase)) 
@@ -548,7 +915,7 @@ void dk_console_register_systems(ecs_world_t *world){
     .callback = flecs_dk_console_setup_system
   });
 
-  ecs_system_init(world, &(ecs_system_desc_t){
+  profiler_system_init(world, &(ecs_system_desc_t){
     .entity = ecs_entity(world, { 
         .name = "render2d_dk_console_system", 
         .add = ecs_ids(ecs_dependson(GlobalPhases.Render2D3Phase)) 
@@ -556,14 +923,16 @@ void dk_console_register_systems(ecs_world_t *world){
     .callback = render2d_dk_console_system
   });
 
-  ecs_observer(world, {
+  profiler_observer(world, {
+    .entity = ecs_entity(world, { .name = "flecs_dk_console_cleanup_event_system" }),
     // Not interested in any specific component
     .query.terms = {{ EcsAny, .src.id = CleanUpModule }},
     .events = { CleanUpEvent },
     .callback = flecs_dk_console_cleanup_event_system
   });
 
-  ecs_observer(world, {
+  profiler_observer(world, {
+    .entity = ecs_entity(world, { .name = "dk_console_event_system" }),
     // Not interested in any specific component
     .query.terms = {{ EcsAny, .src.id = ConsoleModule }},
     .events = { ConsoleEvent },
@@ -578,6 +947,10 @@ void flecs_dk_console_module_init(ecs_world_t *world){
 
   add_module_name(world, "dk_console_module");
 
+  resetQuery = query_cache(world, "console_reset", {
+    .terms = {{ .id = ecs_id(LocalTransform3D) }}
+  });
+
   dk_console_register_systems(world);
 
 }
\ No newline at end of file
@@ -0,0 +1,583 @@
+// per tick input snapshot, record and replay
+// records are delta coded against the tick before, little endian on disk
+#include <stdlib.h>
+#include <string.h>
+#include "flecs_input.h"
+
+#define INPUT_MAGIC "RLIN"
+#define INPUT_HEADER_SIZE 12                    // magic, u32 version, f32 step
+
+// record flags, what follows the flag byte in this order
+#define INPUT_REC_KEYS     0x01                 // u16 n, n x u16 key codes that flipped
+#define INPUT_REC_BUTTONS  0x02                 // u8 down bits
+#define INPUT_REC_POSITION 0x04                 // 2 x f32
+#define INPUT_REC_DELTA    0x08                 // 2 x f32
+#define INPUT_REC_WHEEL    0x10                 // f32, 0 when missing
+
+#if defined(_MSC_VER) && defined(_M_X64)
+  #include <intrin.h>
+  static int input_ctz(uint64_t v){ unsigned long i; _BitScanForward64(&i, v); return (int)i; }
+  static int input_popcount(uint64_t v){ return (int)__popcnt64(v); }
+#elif defined(__GNUC__) || defined(__clang__)
+  static int input_ctz(uint64_t v){ return __builtin_ctzll(v); }
+  static int input_popcount(uint64_t v){ return __builtin_popcountll(v); }
+#else
+  static int input_ctz(uint64_t v){ int i = 0; for (; !(v & 1); v >>= 1) i++; return i; }
+  static int input_popcount(uint64_t v){ int n = 0; for (; v; v &= v - 1) n++; return n; }
+#endif
+
+static bool input_bit(const uint64_t *bits, int i){
+  return (bits[i >> 6] >> (i & 63)) & 1;
+}
+
+static void input_bit_flip(uint64_t *bits, int i){
+  bits[i >> 6] ^= 1ull << (i & 63);
+}
+
+//===============================================
+// STREAM
+//===============================================
+static void input_put_u16(uint8_t **p, uint16_t v){
+  (*p)[0] = (uint8_t)v;
+  (*p)[1] = (uint8_t)(v >> 8);
+  *p += 2;
+}
+
+static void input_put_u32(uint8_t **p, uint32_t v){
+  for (int k = 0; k < 4; k++) (*p)[k] = (uint8_t)(v >> (8 * k));
+  *p += 4;
+}
+
+static void input_put_f32(uint8_t **p, float f){
+  uint32_t v;
+  memcpy(&v, &f, sizeof(v));
+  input_put_u32(p, v);
+}
+
+// reads are bounds checked, a cut stream ends the replay
+typedef struct {
+  const uint8_t *data;
+  int32_t size;
+  int32_t pos;
+  bool isValid;
+} InputReader;
+
+static uint32_t input_get_bytes(InputReader *r, int n){
+  if (r->pos + n > r->size) {
+    r->isValid = false;
+    return 0;
+  }
+  uint32_t v = 0;
+  for (int k = 0; k < n; k++) v |= (uint32_t)r->data[r->pos + k] << (8 * k);
+  r->pos += n;
+  return v;
+}
+
+static float input_get_f32(InputReader *r){
+  uint32_t v = input_get_bytes(r, 4);
+  float f;
+  memcpy(&f, &v, sizeof(f));
+  return f;
+}
+
+static void input_write_header(InputState *in, float step){
+  uint8_t header[INPUT_HEADER_SIZE];
+  uint8_t *p = header;
+  memcpy(p, INPUT_MAGIC, 4);
+  p += 4;
+  input_put_u32(&p, INPUT_STREAM_VERSION);
+  input_put_f32(&p, step);
+  fwrite(header, 1, sizeof(header), in->recordFile);
+  in->recordBytes += (int64_t)sizeof(header);
+  in->hasRecordHeader = true;
+}
+
+static void input_write_record(InputState *in){
+  const InputSnapshot *cur = &in->current;
+  const InputSnapshot *prev = &in->previous;
+  // flag + key list + buttons + 5 floats
+  uint8_t record[1 + 2 + INPUT_KEY_COUNT * 2 + 1 + 5 * 4];
+  uint8_t *p = record + 1;
+  uint8_t flags = 0;
+
+  int flipped = 0;
+  for (int w = 0; w < INPUT_KEY_WORDS; w++) flipped += input_popcount(cur->keys[w] ^ prev->keys[w]);
+  if (flipped > 0) {
+    flags |= INPUT_REC_KEYS;
+    input_put_u16(&p, (uint16_t)flipped);
+    for (int w = 0; w < INPUT_KEY_WORDS; w++) {
+      for (uint64_t diff = cur->keys[w] ^ prev->keys[w]; diff; diff &= diff - 1) {
+        input_put_u16(&p, (uint16_t)(w * 64 + input_ctz(diff)));
+      }
+    }
+  }
+  if (cur->mouseButtons != prev->mouseButtons) {
+    flags |= INPUT_REC_BUTTONS;
+    *p++ = cur->mouseButtons;
+  }
+  if (cur->mousePosition.x != prev->mousePosition.x || cur->mousePosition.y != prev->mousePosition.y) {
+    flags |= INPUT_REC_POSITION;
+    input_put_f32(&p, cur->mousePosition.x);
+    input_put_f32(&p, cur->mousePosition.y);
+  }
+  if (cur->mouseDelta.x != 0.0f || cur->mouseDelta.y != 0.0f) {
+    flags |= INPUT_REC_DELTA;
+    input_put_f32(&p, cur->mouseDelta.x);
+    input_put_f32(&p, cur->mouseDelta.y);
+  }
+  if (cur->wheel != 0.0f) {
+    flags |= INPUT_REC_WHEEL;
+    input_put_f32(&p, cur->wheel);
+  }
+  record[0] = flags;
+
+  size_t size = (size_t)(p - record);
+  fwrite(record, 1, size, in->recordFile);
+  in->recordBytes += (int64_t)size;
+}
+
+// false at the end of the stream, current is left as the last tick
+static bool input_read_record(InputState *in){
+  InputReader r = { in->replayData, in->replaySize, in->replayPos, true };
+  if (r.pos >= r.size) return false;
+  InputSnapshot next = in->current;
+  next.mouseDelta = (Vector2){ 0.0f, 0.0f };
+  next.wheel = 0.0f;
+
+  uint8_t flags = (uint8_t)input_get_bytes(&r, 1);
+  if (flags & INPUT_REC_KEYS) {
+    int n = (int)input_get_bytes(&r, 2);
+    for (int i = 0; i < n && r.isValid; i++) {
+      int key = (int)input_get_bytes(&r, 2);
+      if (key < INPUT_KEY_COUNT) input_bit_flip(next.keys, key);
+    }
+  }
+  if (flags & INPUT_REC_BUTTONS) next.mouseButtons = (uint8_t)input_get_bytes(&r, 1);
+  if (flags & INPUT_REC_POSITION) {
+    next.mousePosition.x = input_get_f32(&r);
+    next.mousePosition.y = input_get_f32(&r);
+  }
+  if (flags & INPUT_REC_DELTA) {
+    next.mouseDelta.x = input_get_f32(&r);
+    next.mouseDelta.y = input_get_f32(&r);
+  }
+  if (flags & INPUT_REC_WHEEL) next.wheel = input_get_f32(&r);
+  if (!r.isValid) {
+    ecs_print(1, "[input] replay cut at byte %d", in->replayPos);
+    return false;
+  }
+
+  in->current = next;
+  in->replayPos = r.pos;
+  in->replayTicks++;
+  return true;
+}
+
+//===============================================
+// RECORD / REPLAY
+//===============================================
+void input_stop(InputState *in){
+  // previous holds replayed keys, a key held for real now is only found by asking all
+  if (in->mode == INPUT_REPLAY) in->needsFullScan = true;
+  if (in->recordFile) {
+    fclose(in->recordFile);
+    in->recordFile = NULL;
+    ecs_print(1, "[input] recorded %lld bytes", (long long)in->recordBytes);
+  }
+  ecs_os_free(in->replayData);
+  in->replayData = NULL;
+  in->replaySize = 0;
+  in->replayPos = 0;
+  in->mode = INPUT_LIVE;
+}
+
+bool input_record_start(InputState *in, const char *path){
+  input_stop(in);
+  in->recordFile = fopen(path, "wb");
+  if (!in->recordFile) {
+    ecs_print(1, "[input] can not write %s", path);
+    return false;
+  }
+  in->mode = INPUT_RECORD;
+  in->recordBytes = 0;
+  in->hasRecordHeader = false;
+  ecs_print(1, "[input] recording to %s", path);
+  return true;
+}
+
+bool input_replay_start(InputState *in, const char *path){
+  input_stop(in);
+  FILE *f = fopen(path, "rb");
+  if (!f) {
+    ecs_print(1, "[input] can not read %s", path);
+    return false;
+  }
+  fseek(f, 0, SEEK_END);
+  long size = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  uint8_t *data = size > 0 ? ecs_os_malloc_n(uint8_t, size) : NULL;
+  bool isRead = data && fread(data, 1, (size_t)size, f) == (size_t)size;
+  fclose(f);
+
+  InputReader r = { data, (int32_t)size, 4, isRead };
+  uint32_t version = input_get_bytes(&r, 4);
+  float step = input_get_f32(&r);
+  if (!isRead || size < INPUT_HEADER_SIZE || memcmp(data, INPUT_MAGIC, 4) != 0 || version != INPUT_STREAM_VERSION) {
+    ecs_print(1, "[input] %s is not an input stream (version %d)", path, INPUT_STREAM_VERSION);
+    ecs_os_free(data);
+    return false;
+  }
+
+  in->replayData = data;
+  in->replaySize = (int32_t)size;
+  in->replayPos = INPUT_HEADER_SIZE;
+  in->replayStep = step;
+  in->replayTicks = 0;
+  in->isReplayDone = false;
+  in->mode = INPUT_REPLAY;
+  // same start state as the recording
+  in->current = (InputSnapshot){0};
+  in->previous = (InputSnapshot){0};
+  memset(in->pressed, 0, sizeof(in->pressed));
+  memset(in->released, 0, sizeof(in->released));
+  in->eventCount = 0;
+  in->queueCount = 0;
+  in->pendingDelta = (Vector2){0};
+  in->pendingWheel = 0.0f;
+  ecs_print(1, "[input] replaying %s, %ld bytes, step %.6f", path, size, step);
+  return true;
+}
+
+void input_pump(InputState *in, int64_t frame){
+  // mouse delta and wheel are per displayed frame in raylib, add them up
+  // once per frame, the first tick that polls takes the sum
+  if (frame != in->pumpFrame) {
+    in->pumpFrame = frame;
+    if (in->mode != INPUT_REPLAY) {
+      Vector2 d = GetMouseDelta();
+      in->pendingDelta.x += d.x;
+      in->pendingDelta.y += d.y;
+      in->pendingWheel += GetMouseWheelMove();
+    }
+  }
+  // replay ignores the keyboard but still empties the queue
+  for (int key = GetKeyPressed(); key != 0; key = GetKeyPressed()) {
+    if (in->mode == INPUT_REPLAY || key < 0 || key >= INPUT_KEY_COUNT) continue;
+    if (in->queueCount < INPUT_QUEUE_SIZE) {
+      in->queue[in->queueCount++] = (int16_t)key;
+    } else {
+      in->droppedEvents++;
+    }
+  }
+}
+
+// queued presses + keys down last tick that still are, only those are asked
+// again. A full queue can have lost presses, then every key is asked, the
+// same for the first live tick (start, end of a replay).
+static void input_poll(InputState *in, InputSnapshot *s){
+  memset(s->keys, 0, sizeof(s->keys));
+  if (in->needsFullScan || in->queueCount == INPUT_QUEUE_SIZE) {
+    in->needsFullScan = false;
+    for (int key = 0; key < INPUT_KEY_COUNT; key++) {
+      if (IsKeyDown(key)) s->keys[key >> 6] |= 1ull << (key & 63);
+    }
+  }
+  for (int32_t i = 0; i < in->queueCount; i++) {
+    s->keys[in->queue[i] >> 6] |= 1ull << (in->queue[i] & 63);
+  }
+  for (int w = 0; w < INPUT_KEY_WORDS; w++) {
+    for (uint64_t held = in->previous.keys[w]; held; held &= held - 1) {
+      int key = w * 64 + input_ctz(held);
+      if (IsKeyDown(key)) s->keys[w] |= 1ull << (key & 63);
+    }
+  }
+  s->mouseButtons = 0;
+  for (int b = 0; b < INPUT_MOUSE_BUTTON_COUNT; b++) {
+    if (IsMouseButtonDown(b)) s->mouseButtons |= (uint8_t)(1u << b);
+  }
+  s->mousePosition = GetMousePosition();
+  s->mouseDelta = in->pendingDelta;
+  s->wheel = in->pendingWheel;
+  in->pendingDelta = (Vector2){0};
+  in->pendingWheel = 0.0f;
+}
+
+static void input_push_event(InputState *in, int key, bool isDown){
+  if (in->eventCount == INPUT_QUEUE_SIZE) {
+    in->droppedEvents++;
+    return;
+  }
+  in->events[in->eventCount++] = (InputKeyEvent){ .key = (int16_t)key, .isDown = isDown };
+}
+
+// one pass over the words, then the event list: queued presses keep their
+// order, the rest (replay, full queue) and the releases go by key code
+static void input_edges(InputState *in){
+  uint64_t todo[INPUT_KEY_WORDS];
+  for (int w = 0; w < INPUT_KEY_WORDS; w++) {
+    uint64_t changed = in->current.keys[w] ^ in->previous.keys[w];
+    in->pressed[w] = changed & in->current.keys[w];
+    in->released[w] = changed & in->previous.keys[w];
+    todo[w] = in->pressed[w];
+  }
+  in->eventCount = 0;
+  for (int32_t i = 0; i < in->queueCount; i++) {
+    int key = in->queue[i];
+    if (!input_bit(todo, key)) continue;
+    input_bit_flip(todo, key);
+    input_push_event(in, key, true);
+  }
+  in->queueCount = 0;
+  for (int w = 0; w < INPUT_KEY_WORDS; w++) {
+    for (uint64_t bits = todo[w]; bits; bits &= bits - 1) input_push_event(in, w * 64 + input_ctz(bits), true);
+  }
+  for (int w = 0; w < INPUT_KEY_WORDS; w++) {
+    for (uint64_t bits = in->released[w]; bits; bits &= bits - 1) input_push_event(in, w * 64 + input_ctz(bits), false);
+  }
+}
+
+void input_update(InputState *in, bool canPoll, float step){
+  in->previous = in->current;
+  in->tick++;
+
+  if (in->mode == INPUT_REPLAY) {
+    if (in->replayTicks == 0 && in->replayStep != step) {
+      ecs_print(1, "[input] replay step %.6f, logic step %.6f, the run will differ", in->replayStep, step);
+    }
+    if (input_read_record(in)) {
+      in->queueCount = 0;
+      input_edges(in);
+      return;
+    }
+    ecs_print(1, "[input] replay done, %lld ticks", (long long)in->replayTicks);
+    input_stop(in);
+    in->isReplayDone = true;
+    // key state falls back to live (or nothing) from the next tick
+  }
+
+  if (canPoll) {
+    input_poll(in, &in->current);
+  } else {
+    in->current = (InputSnapshot){0};
+  }
+  input_edges(in);
+
+  if (in->mode == INPUT_RECORD) {
+    if (!in->hasRecordHeader) input_write_header(in, step);
+    input_write_record(in);
+  }
+}
+
+//===============================================
+// QUERIES
+//===============================================
+bool input_key_down(const InputState *in, int key){
+  if (!in || key < 0 || key >= INPUT_KEY_COUNT) return false;
+  return input_bit(in->current.keys, key);
+}
+
+bool input_key_pressed(const InputState *in, int key){
+  if (!in || key < 0 || key >= INPUT_KEY_COUNT) return false;
+  return input_bit(in->pressed, key);
+}
+
+bool input_key_released(const InputState *in, int key){
+  if (!in || key < 0 || key >= INPUT_KEY_COUNT) return false;
+  return input_bit(in->released, key);
+}
+
+int32_t input_key_events(const InputState *in, const InputKeyEvent **events){
+  if (!in) return 0;
+  *events = in->events;
+  return in->eventCount;
+}
+
+bool input_mouse_down(const InputState *in, int button){
+  if (!in || button < 0 || button >= INPUT_MOUSE_BUTTON_COUNT) return false;
+  return (in->current.mouseButtons >> button) & 1;
+}
+
+bool input_mouse_pressed(const InputState *in, int button){
+  if (!in || button < 0 || button >= INPUT_MOUSE_BUTTON_COUNT) return false;
+  return ((in->current.mouseButtons & ~in->previous.mouseButtons) >> button) & 1;
+}
+
+Vector2 input_mouse_delta(const InputState *in){
+  return in ? in->current.mouseDelta : (Vector2){ 0.0f, 0.0f };
+}
+
+Vector2 input_mouse_position(const InputState *in){
+  return in ? in->current.mousePosition : (Vector2){ 0.0f, 0.0f };
+}
+
+float input_mouse_wheel(const InputState *in){
+  return in ? in->current.wheel : 0.0f;
+}
+
+void input_print(const InputState *in){
+  if (!in) return;
+  static const char *modes[] = { "live", "record", "replay" };
+  ecs_print(1, "input %s, tick %lld, %d key events, %lld dropped", modes[in->mode], (long long)in->tick,
+    in->eventCount, (long long)in->droppedEvents);
+  if (in->mode == INPUT_RECORD) {
+    ecs_print(1, "  recorded %lld bytes", (long long)in->recordBytes);
+  } else if (in->mode == INPUT_REPLAY) {
+    ecs_print(1, "  replay tick %lld, byte %d / %d", (long long)in->replayTicks, in->replayPos, in->replaySize);
+  }
+}
+
+//===============================================
+// ACTIONS
+//===============================================
+
+static const char *input_action_names[ACTION_COUNT] = {
+  "move_forward", "move_back", "move_left", "move_right", "move_up", "move_down",
+  "jump", "reset", "camera_mode", "capture_mouse", "release_mouse"
+};
+
+const char *input_action_name(InputAction action){
+  return (action >= 0 && action < ACTION_COUNT) ? input_action_names[action] : "unknown";
+}
+
+int input_action_find(const char *name){
+  for (int a = 0; a < ACTION_COUNT; a++) {
+    if (strcmp(input_action_names[a], name) == 0) return a;
+  }
+  return -1;
+}
+
+void input_actions_compile(InputActionMap *map){
+  memset(map->keyActions, 0, sizeof(map->keyActions));
+  memset(map->buttonActions, 0, sizeof(map->buttonActions));
+  memset(map->boundKeys, 0, sizeof(map->boundKeys));
+  for (int32_t i = 0; i < map->bindingCount; i++) {
+    const InputBinding *b = &map->bindings[i];
+    if (b->isMouse) {
+      map->buttonActions[b->code] |= INPUT_ACTION_BIT(b->action);
+    } else {
+      map->keyActions[b->code] |= INPUT_ACTION_BIT(b->action);
+      map->boundKeys[b->code >> 6] |= 1ull << (b->code & 63);
+    }
+  }
+}
+
+static bool input_action_add(InputActionMap *map, InputAction action, int code, bool isMouse){
+  if (action < 0 || action >= ACTION_COUNT) return false;
+  if (code < 0 || code >= (isMouse ? INPUT_MOUSE_BUTTON_COUNT : INPUT_KEY_COUNT)) return false;
+  // KEY_NULL, never down
+  if (!isMouse && code == 0) return false;
+  if (map->bindingCount == INPUT_MAX_BINDINGS) return false;
+  map->bindings[map->bindingCount++] = (InputBinding){ .code = (int16_t)code, .isMouse = isMouse, .action = (uint8_t)action };
+  return true;
+}
+
+bool input_action_bind(InputActionMap *map, InputAction action, int code, bool isMouse){
+  if (!input_action_add(map, action, code, isMouse)) return false;
+  input_actions_compile(map);
+  return true;
+}
+
+void input_action_unbind(InputActionMap *map, InputAction action){
+  int32_t n = 0;
+  for (int32_t i = 0; i < map->bindingCount; i++) {
+    if (map->bindings[i].action != action) map->bindings[n++] = map->bindings[i];
+  }
+  map->bindingCount = n;
+  input_actions_compile(map);
+}
+
+void input_actions_default(InputActionMap *map){
+  map->bindingCount = 0;
+  input_action_add(map, ACTION_MOVE_FORWARD, KEY_W, false);
+  input_action_add(map, ACTION_MOVE_BACK, KEY_S, false);
+  input_action_add(map, ACTION_MOVE_LEFT, KEY_A, false);
+  input_action_add(map, ACTION_MOVE_RIGHT, KEY_D, false);
+  input_action_add(map, ACTION_MOVE_UP, KEY_SPACE, false);
+  input_action_add(map, ACTION_MOVE_DOWN, KEY_LEFT_SHIFT, false);
+  input_action_add(map, ACTION_JUMP, KEY_SPACE, false);
+  input_action_add(map, ACTION_RESET, KEY_R, false);
+  input_action_add(map, ACTION_CAMERA_MODE, KEY_TAB, false);
+  input_action_add(map, ACTION_RELEASE_MOUSE, KEY_ESCAPE, false);
+  // any common key or button grabs the mouse
+  for (int key = KEY_A; key <= KEY_Z; key++) input_action_add(map, ACTION_CAPTURE_MOUSE, key, false);
+  for (int key = KEY_ZERO; key <= KEY_NINE; key++) input_action_add(map, ACTION_CAPTURE_MOUSE, key, false);
+  input_action_add(map, ACTION_CAPTURE_MOUSE, KEY_SPACE, false);
+  input_action_add(map, ACTION_CAPTURE_MOUSE, KEY_ENTER, false);
+  input_action_add(map, ACTION_CAPTURE_MOUSE, KEY_TAB, false);
+  for (int b = 0; b < INPUT_MOUSE_BUTTON_COUNT; b++) input_action_add(map, ACTION_CAPTURE_MOUSE, b, true);
+  input_actions_compile(map);
+}
+
+static uint32_t input_actions_of(const InputActionMap *map, const uint64_t keys[INPUT_KEY_WORDS]){
+  uint32_t actions = 0;
+  for (int w = 0; w < INPUT_KEY_WORDS; w++) {
+    for (uint64_t bits = keys[w] & map->boundKeys[w]; bits; bits &= bits - 1) {
+      actions |= map->keyActions[w * 64 + input_ctz(bits)];
+    }
+  }
+  return actions;
+}
+
+static float input_axis(uint32_t down, InputAction positive, InputAction negative){
+  return (float)((down >> positive) & 1) - (float)((down >> negative) & 1);
+}
+
+void input_actions_resolve(const InputActionMap *map, const InputState *in, InputActions *out){
+  out->down = input_actions_of(map, in->current.keys);
+  out->pressed = input_actions_of(map, in->pressed);
+  out->released = input_actions_of(map, in->released);
+  uint8_t buttons = in->current.mouseButtons;
+  uint8_t buttonsPressed = buttons & ~in->previous.mouseButtons;
+  uint8_t buttonsReleased = in->previous.mouseButtons & ~buttons;
+  for (int b = 0; b < INPUT_MOUSE_BUTTON_COUNT; b++) {
+    if ((buttons >> b) & 1) out->down |= map->buttonActions[b];
+    if ((buttonsPressed >> b) & 1) out->pressed |= map->buttonActions[b];
+    if ((buttonsReleased >> b) & 1) out->released |= map->buttonActions[b];
+  }
+  out->axes[INPUT_AXIS_MOVE_X] = input_axis(out->down, ACTION_MOVE_RIGHT, ACTION_MOVE_LEFT);
+  out->axes[INPUT_AXIS_MOVE_Y] = input_axis(out->down, ACTION_MOVE_FORWARD, ACTION_MOVE_BACK);
+  out->axes[INPUT_AXIS_MOVE_Z] = input_axis(out->down, ACTION_MOVE_UP, ACTION_MOVE_DOWN);
+  out->axes[INPUT_AXIS_LOOK_X] = in->current.mouseDelta.x;
+  out->axes[INPUT_AXIS_LOOK_Y] = in->current.mouseDelta.y;
+}
+
+void input_actions_print(const InputActionMap *map){
+  ecs_print(1, "input actions, %d bindings", map->bindingCount);
+  for (int a = 0; a < ACTION_COUNT; a++) {
+    char line[256];
+    int len = 0;
+    for (int32_t i = 0; i < map->bindingCount && len < (int)sizeof(line) - 16; i++) {
+      const InputBinding *b = &map->bindings[i];
+      if (b->action != a) continue;
+      len += snprintf(line + len, sizeof(line) - len, " %s%d", b->isMouse ? "mouse" : "", b->code);
+    }
+    line[len] = '\0';
+    ecs_print(1, "  %-14s%s", input_action_names[a], line);
+  }
+}
+
+// record file is flushed even without the clean up events
+static void input_fini(ecs_world_t *world, void *ctx){
+  (void)ctx;
+  InputState *in = ecs_singleton_get_mut(world, InputState);
+  if (in) input_stop(in);
+}
+
+void flecs_input_module_init(ecs_world_t *world){
+  ecs_print(1, "Initializing input module...");
+  ECS_COMPONENT_DEFINE(world, InputState);
+  ecs_singleton_set(world, InputState, { .mode = INPUT_LIVE, .needsFullScan = true });
+  ecs_atfini(world, input_fini, NULL);
+
+  ECS_COMPONENT_DEFINE(world, InputActionMap);
+  input_actions_default(ecs_singleton_ensure(world, InputActionMap));
+
+  InputState *in = ecs_singleton_get_mut(world, InputState);
+  const char *replay = getenv("RL_INPUT_REPLAY");
+  const char *record = getenv("RL_INPUT_RECORD");
+  if (replay) {
+    input_replay_start(in, replay);
+  } else if (record) {
+    input_record_start(in, record);
+  }
+}
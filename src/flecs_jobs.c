@@ -0,0 +1,161 @@
+// time sliced job queue
+// binary heap on (priority, seq), drained once per displayed frame
+#include <string.h>
+#include "flecs_module.h"
+#include "flecs_jobs.h"
+
+static bool job_less(const Job *a, const Job *b){
+  if (a->priority != b->priority) return a->priority < b->priority;
+  return a->seq < b->seq;
+}
+
+static void job_heap_push(JobQueue *q, const Job *job){
+  if (q->count == q->capacity) {
+    q->capacity = q->capacity ? q->capacity * 2 : 32;
+    q->heap = ecs_os_realloc_n(q->heap, Job, q->capacity);
+  }
+  int32_t i = q->count++;
+  while (i > 0) {
+    int32_t parent = (i - 1) / 2;
+    if (!job_less(job, &q->heap[parent])) break;
+    q->heap[i] = q->heap[parent];
+    i = parent;
+  }
+  q->heap[i] = *job;
+  q->stats.pendingByPriority[job->priority]++;
+}
+
+static Job job_heap_pop(JobQueue *q){
+  Job top = q->heap[0];
+  Job last = q->heap[--q->count];
+  int32_t i = 0;
+  for (;;) {
+    int32_t child = i * 2 + 1;
+    if (child >= q->count) break;
+    if (child + 1 < q->count && job_less(&q->heap[child + 1], &q->heap[child])) child++;
+    if (!job_less(&q->heap[child], &last)) break;
+    q->heap[i] = q->heap[child];
+    i = child;
+  }
+  if (q->count > 0) q->heap[i] = last;
+  q->stats.pendingByPriority[top.priority]--;
+  return top;
+}
+
+bool job_queue_push(ecs_world_t *world, const char *name, JobPriority priority, JobCallback callback, void *ctx){
+  JobQueue *q = ecs_singleton_get_mut(world, JobQueue);
+  if (!q || q->isClosed || !callback) return false;
+  if (priority < 0 || priority >= JOB_PRIORITY_COUNT) priority = JOB_PRIORITY_NORMAL;
+
+  Job job = {
+    .callback = callback,
+    .ctx = ctx,
+    .priority = priority,
+    .seq = q->nextSeq++,
+    .queuedFrame = q->frame
+  };
+  snprintf(job.name, sizeof(job.name), "%s", name ? name : "job");
+  job_heap_push(q, &job);
+  q->stats.pushed++;
+  return true;
+}
+
+void job_queue_set_budget(ecs_world_t *world, int32_t budgetUs){
+  JobQueue *q = ecs_singleton_get_mut(world, JobQueue);
+  if (!q) return;
+  q->budgetUs = budgetUs > 0 ? budgetUs : 0;
+}
+
+int32_t job_queue_run(JobQueue *q, ecs_world_t *world, int32_t budgetUs){
+  q->frame++;
+  q->stats.lastSlices = 0;
+  q->stats.lastUs = 0.0f;
+  if (q->count == 0) return 0;
+
+  uint64_t budgetNs = (uint64_t)budgetUs * 1000;
+  uint64_t start = ecs_os_now();
+  uint64_t elapsed = 0;
+  int32_t slices = 0;
+  // at least one slice so a small budget still makes progress
+  do {
+    // popped first, the callback may push (and grow the heap)
+    Job job = job_heap_pop(q);
+    if (!job.isStarted) {
+      int64_t wait = q->frame - job.queuedFrame;
+      if (wait > q->stats.maxWaitFrames) q->stats.maxWaitFrames = wait;
+      job.isStarted = true;
+    }
+
+    uint64_t sliceStart = ecs_os_now();
+    trace_begin("job slice", "jobs");
+    bool done = job.callback(world, job.ctx);
+    trace_end();
+    uint64_t now = ecs_os_now();
+
+    float sliceUs = (float)((double)(now - sliceStart) * 1e-3);
+    if (sliceUs > q->stats.maxSliceUs) {
+      q->stats.maxSliceUs = sliceUs;
+      memcpy(q->stats.maxSliceName, job.name, sizeof(job.name));
+    }
+    q->stats.slices++;
+    slices++;
+    if (done) {
+      q->stats.completed++;
+    } else {
+      // behind the other jobs of its priority
+      job.seq = q->nextSeq++;
+      job_heap_push(q, &job);
+    }
+    elapsed = now - start;
+  } while (q->count > 0 && elapsed < budgetNs);
+
+  q->stats.lastSlices = slices;
+  q->stats.lastUs = (float)((double)elapsed * 1e-3);
+  if (elapsed > budgetNs) q->stats.overBudgetFrames++;
+  return slices;
+}
+
+void job_queue_print(const JobQueue *q){
+  const JobQueueStats *s = &q->stats;
+  ecs_print(1, "jobs, budget %d us, pending %d (high %d normal %d low %d)", q->budgetUs, q->count,
+    s->pendingByPriority[JOB_PRIORITY_HIGH], s->pendingByPriority[JOB_PRIORITY_NORMAL],
+    s->pendingByPriority[JOB_PRIORITY_LOW]);
+  ecs_print(1, "  pushed %lld completed %lld slices %lld dropped %lld",
+    (long long)s->pushed, (long long)s->completed, (long long)s->slices, (long long)s->dropped);
+  ecs_print(1, "  last frame %d slices %.1f us, over budget %lld frames, max wait %lld frames",
+    s->lastSlices, s->lastUs, (long long)s->overBudgetFrames, (long long)s->maxWaitFrames);
+  ecs_print(1, "  max slice %.1f us (%s)", s->maxSliceUs, s->maxSliceName[0] ? s->maxSliceName : "-");
+}
+
+// after the frame is drawn, what is left of it goes to deferred work
+void job_queue_run_system(ecs_iter_t *it){
+  JobQueue *q = ecs_singleton_get_mut(it->world, JobQueue);
+  if (!q || q->isClosed) return;
+  job_queue_run(q, it->world, q->budgetUs);
+}
+
+void job_queue_fini(ecs_world_t *world){
+  JobQueue *q = ecs_singleton_get_mut(world, JobQueue);
+  if (!q || q->isClosed) return;
+  if (q->count > 0) {
+    ecs_print(1, "[jobs] dropping %d queued jobs", q->count);
+  }
+  q->stats.dropped += q->count;
+  memset(q->stats.pendingByPriority, 0, sizeof(q->stats.pendingByPriority));
+  ecs_os_free(q->heap);
+  q->heap = NULL;
+  q->count = 0;
+  q->capacity = 0;
+  q->isClosed = true;
+}
+
+void flecs_jobs_module_init(ecs_world_t *world){
+  ecs_print(1, "Initializing jobs module...");
+  ECS_COMPONENT_DEFINE(world, JobQueue);
+  ecs_singleton_set(world, JobQueue, { .budgetUs = JOB_QUEUE_BUDGET_US });
+
+  profiler_system_init(world, &(ecs_system_desc_t){
+    .entity = ecs_entity(world, { .name = "job_queue_run_system", .add = ecs_ids(ecs_dependson(GlobalPhases.EndRenderPhase)) }),
+    .callback = job_queue_run_system
+  });
+}
@@ -0,0 +1,126 @@
+// input to display latency, per tick stage stamps + percentiles
+#include <stdlib.h>
+#include <string.h>
+#include "flecs_latency.h"
+
+// one world per app, stamped from the module frame, raylib and transform code
+static LatencyStats latency;
+static int64_t latencyFrameId;
+static int32_t latencyFrameTicks;               // Ticks of the open frame, the last ones in history
+static uint64_t latencyFramePoll;               // Poll the ticks of the open frame read
+static uint64_t latencyPoll;                    // Oldest poll no tick has sampled yet, 0 = none
+static bool isLatencyFrameOpen;
+
+static const struct { LatencyStage from, to; const char *name; } latency_metrics[LATENCY_METRIC_COUNT] = {
+  { LATENCY_POLL, LATENCY_PRESENT, "input -> present" },
+  { LATENCY_SAMPLE, LATENCY_PRESENT, "sample -> present" },
+  { LATENCY_POLL, LATENCY_SIMULATED, "input -> simulated" },
+  { LATENCY_SAMPLE, LATENCY_TRANSFORM, "sample -> transform" },
+  { LATENCY_SAMPLE, LATENCY_SIMULATED, "sample -> simulated" }
+};
+
+// i = 0 is the newest record
+static LatencyTick *latency_recent(int32_t i){
+  return &latency.history[(latency.head - 1 - i + LATENCY_HISTORY) % LATENCY_HISTORY];
+}
+
+void latency_frame_begin(void){
+  uint64_t now = ecs_os_now();
+  latencyFrameId++;
+  latencyFrameTicks = 0;
+  latencyFramePoll = 0;
+  isLatencyFrameOpen = true;
+  // headless (or the first frame) has no EndDrawing, input is there at the frame start
+  if (latencyPoll == 0) latencyPoll = now;
+}
+
+void latency_sample(int64_t tick, bool hasInput){
+  if (!isLatencyFrameOpen) return;
+  // the events the ticks of this frame read were polled here
+  if (latencyFrameTicks == 0) {
+    latencyFramePoll = latencyPoll;
+    latencyPoll = 0;
+  }
+  LatencyTick *t = &latency.history[latency.head];
+  *t = (LatencyTick){ .tick = tick, .frameId = latencyFrameId, .hasInput = hasInput };
+  t->stamps[LATENCY_SAMPLE] = ecs_os_now();
+  t->stamps[LATENCY_POLL] = latencyFramePoll;
+  latency.head = (latency.head + 1) % LATENCY_HISTORY;
+  if (latency.count < LATENCY_HISTORY) latency.count++;
+  latency.ticks++;
+  if (hasInput) latency.inputTicks++;
+  if (latencyFrameTicks < LATENCY_HISTORY) latencyFrameTicks++;
+}
+
+void latency_mark(LatencyStage stage){
+  if (!isLatencyFrameOpen) return;
+  uint64_t now = ecs_os_now();
+  if (stage == LATENCY_PRESENT) {
+    for (int32_t i = 0; i < latencyFrameTicks && i < latency.count; i++) {
+      latency_recent(i)->stamps[LATENCY_PRESENT] = now;
+    }
+    // raylib polls inside EndDrawing, the next frame's input is from here
+    if (latencyPoll == 0) latencyPoll = now;
+    return;
+  }
+  if (latencyFrameTicks > 0 && latency.count > 0) latency_recent(0)->stamps[stage] = now;
+}
+
+void latency_frame_end(void){
+  if (!isLatencyFrameOpen) return;
+  isLatencyFrameOpen = false;
+  latency.frames++;
+  // no tick, nothing read the input, it shows up in a later frame
+  if (latencyFrameTicks == 0) latency.idleFrames++;
+}
+
+const LatencyStats *latency_stats(void){
+  return &latency;
+}
+
+const char *latency_metric_name(LatencyMetric metric){
+  return latency_metrics[metric].name;
+}
+
+static int latency_compare_float(const void *a, const void *b){
+  float x = *(const float *)a;
+  float y = *(const float *)b;
+  return (x > y) - (x < y);
+}
+
+LatencySummary latency_summary(LatencyMetric metric, bool inputOnly){
+  LatencySummary s = {0};
+  float values[LATENCY_HISTORY];
+  LatencyStage from = latency_metrics[metric].from;
+  LatencyStage to = latency_metrics[metric].to;
+  for (int32_t i = 0; i < latency.count; i++) {
+    const LatencyTick *f = &latency.history[i];
+    if (inputOnly && !f->hasInput) continue;
+    if (f->stamps[from] == 0 || f->stamps[to] < f->stamps[from]) continue;
+    values[s.count++] = (float)((double)(f->stamps[to] - f->stamps[from]) * 1e-6);
+  }
+  if (s.count == 0) return s;
+  qsort(values, (size_t)s.count, sizeof(float), latency_compare_float);
+  s.p50 = values[(int32_t)((s.count - 1) * 0.50f + 0.5f)];
+  s.p95 = values[(int32_t)((s.count - 1) * 0.95f + 0.5f)];
+  s.p99 = values[(int32_t)((s.count - 1) * 0.99f + 0.5f)];
+  s.max = values[s.count - 1];
+  return s;
+}
+
+void latency_reset(void){
+  latency = (LatencyStats){0};
+  latencyFrameTicks = 0;
+}
+
+void latency_print(void){
+  ecs_print(1, "latency, %lld ticks, %lld with input | %lld frames, %lld without a tick",
+    (long long)latency.ticks, (long long)latency.inputTicks, (long long)latency.frames, (long long)latency.idleFrames);
+  for (int m = 0; m < LATENCY_METRIC_COUNT; m++) {
+    LatencySummary all = latency_summary((LatencyMetric)m, false);
+    if (all.count == 0) continue;
+    LatencySummary in = latency_summary((LatencyMetric)m, true);
+    ecs_print(1, "  %-20s p50 %7.3f p95 %7.3f p99 %7.3f max %7.3f ms | input ticks p99 %7.3f ms (%d)",
+      latency_metrics[m].name, all.p50, all.p95, all.p99, all.max, in.p99, in.count);
+  }
+}
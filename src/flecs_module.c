@@ -1,9 +1,18 @@
 // To set up flecs module needed for handle on start set up and run time update order.
 
 #include "flecs_module.h"
+#include "flecs_latency.h"
+#include "flecs_hash.h"
 
 FlecsPhases GlobalPhases = {0};
 
+// systems in the same phase run in declaration order
+static int flecs_phase_entity_compare(ecs_entity_t e1, const void *ptr1, ecs_entity_t e2, const void *ptr2){
+  (void)ptr1;
+  (void)ptr2;
+  return (e1 > e2) - (e1 < e2);
+}
+
 void flecs_init_phases(ecs_world_t *world, FlecsPhases *phases){
   // Define custom phases
 
@@ -16,6 +25,7 @@ void flecs_init_phases(ecs_world_t *world, FlecsPhases *phases){
   phases->BeginRenderPhase = ecs_new_w_id(world, EcsPhase);
   //only 3d model render and 2d will not work here.
   phases->BeginCamera3DPhase = ecs_new_w_id(world, EcsPhase);
+  phases->CullCamera3DPhase = ecs_new_w_id(world, EcsPhase);
   phases->UpdateCamera3DPhase = ecs_new_w_id(world, EcsPhase);
   phases->EndCamera3DPhase = ecs_new_w_id(world, EcsPhase);
   //only 2d render if 3d will not work here.
@@ -33,19 +43,78 @@ void flecs_init_phases(ecs_world_t *world, FlecsPhases *phases){
   ecs_add_pair(world, phases->LogicUpdatePhase, EcsDependsOn, EcsPreUpdate);
   ecs_add_pair(world, phases->BeginRenderPhase, EcsDependsOn, phases->LogicUpdatePhase);
   ecs_add_pair(world, phases->BeginCamera3DPhase, EcsDependsOn, phases->BeginRenderPhase);
-  ecs_add_pair(world, phases->UpdateCamera3DPhase, EcsDependsOn, phases->BeginCamera3DPhase);
+  ecs_add_pair(world, phases->CullCamera3DPhase, EcsDependsOn, phases->BeginCamera3DPhase);
+  ecs_add_pair(world, phases->UpdateCamera3DPhase, EcsDependsOn, phases->CullCamera3DPhase);
   ecs_add_pair(world, phases->EndCamera3DPhase, EcsDependsOn, phases->UpdateCamera3DPhase);
   ecs_add_pair(world, phases->Render2D1Phase, EcsDependsOn, phases->EndCamera3DPhase);
   ecs_add_pair(world, phases->Render2D2Phase, EcsDependsOn, phases->Render2D1Phase);
   ecs_add_pair(world, phases->Render2D3Phase, EcsDependsOn, phases->Render2D2Phase);
   ecs_add_pair(world, phases->EndRenderPhase, EcsDependsOn, phases->Render2D3Phase);
 
+  // names for the profiler and the explorer
+  ecs_set_name(world, phases->OnSetUpPhase, "OnSetUpPhase");
+  ecs_set_name(world, phases->OnSetupGraphicPhase, "OnSetupGraphicPhase");
+  ecs_set_name(world, phases->OnSetupModulePhase, "OnSetupModulePhase");
+  ecs_set_name(world, phases->OnSetupWorldPhase, "OnSetupWorldPhase");
+  ecs_set_name(world, phases->LogicUpdatePhase, "LogicUpdatePhase");
+  ecs_set_name(world, phases->BeginRenderPhase, "BeginRenderPhase");
+  ecs_set_name(world, phases->BeginCamera3DPhase, "BeginCamera3DPhase");
+  ecs_set_name(world, phases->CullCamera3DPhase, "CullCamera3DPhase");
+  ecs_set_name(world, phases->UpdateCamera3DPhase, "UpdateCamera3DPhase");
+  ecs_set_name(world, phases->EndCamera3DPhase, "EndCamera3DPhase");
+  ecs_set_name(world, phases->Render2D1Phase, "Render2D1Phase");
+  ecs_set_name(world, phases->Render2D2Phase, "Render2D2Phase");
+  ecs_set_name(world, phases->Render2D3Phase, "Render2D3Phase");
+  ecs_set_name(world, phases->EndRenderPhase, "EndRenderPhase");
+
+  // render phases are split from the logic phases by tag, so one pipeline
+  // does the fixed step simulation and the other draws once per frame
+  phases->RenderPhaseTag = ecs_entity(world, { .name = "RenderPhaseTag" });
+  ecs_entity_t renderPhases[] = {
+    phases->BeginRenderPhase, phases->BeginCamera3DPhase, phases->CullCamera3DPhase,
+    phases->UpdateCamera3DPhase, phases->EndCamera3DPhase, phases->Render2D1Phase,
+    phases->Render2D2Phase, phases->Render2D3Phase, phases->EndRenderPhase
+  };
+  for (size_t i = 0; i < sizeof(renderPhases) / sizeof(renderPhases[0]); i++) {
+    ecs_add_id(world, renderPhases[i], phases->RenderPhaseTag);
+  }
+
+  // same terms as the flecs builtin pipeline + the render tag
+  phases->LogicPipeline = ecs_pipeline(world, {
+    .entity = ecs_entity(world, { .name = "LogicPipeline" }),
+    .query.terms = {
+      { .id = EcsSystem },
+      { .id = EcsPhase, .src.id = EcsCascade, .trav = EcsDependsOn },
+      { .id = ecs_dependson(EcsOnStart), .trav = EcsDependsOn, .oper = EcsNot },
+      { .id = phases->RenderPhaseTag, .src.id = EcsUp, .trav = EcsDependsOn, .oper = EcsNot },
+      { .id = EcsDisabled, .src.id = EcsUp, .trav = EcsDependsOn, .oper = EcsNot },
+      { .id = EcsDisabled, .src.id = EcsUp, .trav = EcsChildOf, .oper = EcsNot }
+    },
+    .query.order_by_callback = flecs_phase_entity_compare
+  });
+
+  phases->RenderPipeline = ecs_pipeline(world, {
+    .entity = ecs_entity(world, { .name = "RenderPipeline" }),
+    .query.terms = {
+      { .id = EcsSystem },
+      { .id = EcsPhase, .src.id = EcsCascade, .trav = EcsDependsOn },
+      { .id = phases->RenderPhaseTag, .src.id = EcsUp, .trav = EcsDependsOn },
+      { .id = EcsDisabled, .src.id = EcsUp, .trav = EcsDependsOn, .oper = EcsNot },
+      { .id = EcsDisabled, .src.id = EcsUp, .trav = EcsChildOf, .oper = EcsNot }
+    },
+    .query.order_by_callback = flecs_phase_entity_compare
+  });
+
+  ecs_set_pipeline(world, phases->LogicPipeline);
 }
 
 void flecs_register_components(ecs_world_t *world){
 
   ECS_COMPONENT_DEFINE(world, PluginModule);
   ECS_COMPONENT_DEFINE(world, ModuleContext);
+  ECS_COMPONENT_DEFINE(world, ModuleRegistry);
+  ECS_COMPONENT_DEFINE(world, SimulationClock);
+  ECS_COMPONENT_DEFINE(world, TaskScheduler);
 
   ShutDownEvent = ecs_new(world);
   ShutDownModule = ecs_entity(world, { .name = "ShutDownModule" });
@@ -76,39 +145,14 @@ void flecs_setup_module_system(ecs_iter_t *it){
   ecs_print(1,"flecs_setup_module_system");
 }
 
+// every module registered and cleaned up, counter only, no query
 void flecs_cleanup_checks_system(ecs_iter_t *it){
   ModuleContext *g_module = ecs_singleton_ensure(it->world, ModuleContext);
-  if(!g_module)return;
-  PluginModule *plugin = ecs_field(it, PluginModule, 0);
-  //ecs_print(1,"checking...");
-
-  ecs_query_t *q = ecs_query(it->world, {
-    .terms = {
-      { .id = ecs_id(PluginModule) },
-    }
-  });
-
-  ecs_iter_t s_it = ecs_query_iter(it->world, q);
-
-  bool isFinishCleanup = false;
-  int count = 0;
-  while (ecs_query_next(&s_it)) {
-    PluginModule *p = ecs_field(&s_it, PluginModule, 0);
-    for (int i = 0; i < s_it.count; i ++) {
-      // ecs_print(1,"Module Name : %s", 
-      //   p[i].name
-      //   //ecs_get_name(s_it.world, s_it.entities[i])
-      // );
-      //ecs_print(1,"isCleanUp %d", p[i].isCleanUp);
-      if(p[i].isCleanUp){
-        isFinishCleanup = true;
-        count+=1;
-      }
-    }
-  }
+  if(!g_module || g_module->isCleanUpModule) return;
+  const ModuleRegistry *reg = ecs_singleton_get(it->world, ModuleRegistry);
+  if(!reg || reg->count == 0) return;
 
-  //ecs_print(1," COUNT: %d Len:%d ", count, s_it.count);
-  if((count == s_it.count && g_module->isCleanUpModule == false) ){
+  if(reg->pending == 0){
     g_module->isCleanUpModule = true;
     ecs_print(1,"ALL MODULES DONE! CLOSE APP!");
     ecs_emit(it->world, &(ecs_event_desc_t) {
@@ -159,17 +203,17 @@ void flecs_close_event_system(ecs_iter_t *it){
 
 void flecs_register_systems(ecs_world_t *world){
 
-  ecs_system_init(world, &(ecs_system_desc_t){
+  profiler_system_init(world, &(ecs_system_desc_t){
     .entity = ecs_entity(world, { 
       .name = "flecs_cleanup_checks_system", 
       .add = ecs_ids(ecs_dependson(GlobalPhases.LogicUpdatePhase)) 
     }),
-    .query.terms = {{ ecs_id(PluginModule), .inout = EcsIn }},
     .callback = flecs_cleanup_checks_system
   });
 
   // Create an entity observer
-  ecs_observer(world, {
+  profiler_observer(world, {
+    .entity = ecs_entity(world, { .name = "flecs_shutdown_event_system" }),
     // Not interested in any specific component
     .query.terms = {{ EcsAny, .src.id = ShutDownModule }},
     .events = { ShutDownEvent },
@@ -183,21 +227,23 @@ void flecs_register_systems(ecs_world_t *world){
   //   .callback = flecs_cleanup_event_system
   // });
 
-  ecs_observer(world, {
+  profiler_observer(world, {
+    .entity = ecs_entity(world, { .name = "flecs_cleanup_graphic_event_system" }),
     // Not interested in any specific component
     .query.terms = {{ EcsAny, .src.id = CleanUpGraphic }},
     .events = { CleanUpGraphicEvent },
     .callback = flecs_cleanup_graphic_event_system
   });
 
-  ecs_observer(world, {
+  profiler_observer(world, {
+    .entity = ecs_entity(world, { .name = "flecs_close_event_system" }),
     // Not interested in any specific component
     .query.terms = {{ EcsAny, .src.id = CloseModule }},
     .events = { CloseEvent },
     .callback = flecs_close_event_system
   });
 
-  ecs_system_init(world, &(ecs_system_desc_t){
+  profiler_system_init(world, &(ecs_system_desc_t){
     .entity = ecs_entity(world, { 
         .name = "flecs_setup_system", 
         .add = ecs_ids(ecs_dependson(GlobalPhases.OnSetUpPhase)) 
@@ -205,7 +251,7 @@ void flecs_register_systems(ecs_world_t *world){
     .callback = flecs_setup_system
   });
 
-  ecs_system_init(world, &(ecs_system_desc_t){
+  profiler_system_init(world, &(ecs_system_desc_t){
     .entity = ecs_entity(world, { 
         .name = "flecs_setup_graphic_system", 
         .add = ecs_ids(ecs_dependson(GlobalPhases.OnSetupGraphicPhase)) 
@@ -213,7 +259,7 @@ void flecs_register_systems(ecs_world_t *world){
     .callback = flecs_setup_graphic_system
   });
 
-  ecs_system_init(world, &(ecs_system_desc_t){
+  profiler_system_init(world, &(ecs_system_desc_t){
     .entity = ecs_entity(world, { 
         .name = "flecs_setup_module_system", 
         .add = ecs_ids(ecs_dependson(GlobalPhases.OnSetupModulePhase)) 
@@ -222,6 +268,58 @@ void flecs_register_systems(ecs_world_t *world){
   });
 }
 //===============================================
+// MODULE REGISTRY
+//===============================================
+#define MODULE_NAME_MAX (sizeof(((PluginModule *)0)->name) - 1)
+
+// FNV-1a of the stored (truncated) name. Two names with one hash: the second
+// goes to the next free key, a lookup walks the keys until the name matches
+// or a key is free.
+static ecs_entity_t module_lookup(const ecs_world_t *world, const ModuleRegistry *reg, const char *name, uint64_t *freeKey){
+  uint64_t key = hash_fnv1a_str(name, MODULE_NAME_MAX);
+  for (ecs_map_val_t *e; (e = ecs_map_get(&reg->index, key)); key++) {
+    const PluginModule *p = ecs_get(world, (ecs_entity_t)*e, PluginModule);
+    if (p && strncmp(p->name, name, MODULE_NAME_MAX) == 0) return (ecs_entity_t)*e;
+  }
+  if (freeKey) *freeKey = key;
+  return 0;
+}
+
+static void flecs_module_registry_fini(ecs_world_t *world, void *ctx){
+  (void)ctx;
+  ModuleRegistry *reg = ecs_singleton_get_mut(world, ModuleRegistry);
+  if (reg) ecs_map_fini(&reg->index);
+}
+
+//===============================================
+// TASK POOL
+//===============================================
+static void flecs_module_task_pool_fini(ecs_world_t *world, void *ctx){
+  (void)ctx;
+  flecs_module_set_task_workers(world, 0);
+}
+
+void flecs_module_set_task_workers(ecs_world_t *world, int32_t workers){
+  TaskScheduler *s = ecs_singleton_get_mut(world, TaskScheduler);
+  if (!s) return;
+  if (s->pool) {
+    task_pool_fini(s->pool);
+    ecs_os_free(s->pool);
+    s->pool = NULL;
+  }
+  if (workers > 0) {
+    s->pool = ecs_os_malloc_t(TaskPool);
+    task_pool_init(s->pool, workers);
+  }
+}
+
+TaskPool *flecs_module_task_pool(const ecs_world_t *world){
+  // benches run systems without flecs_module_init
+  if (!ecs_id(TaskScheduler)) return NULL;
+  const TaskScheduler *s = ecs_singleton_get(world, TaskScheduler);
+  return s ? s->pool : NULL;
+}
+//===============================================
 // INIT MODULE
 //===============================================
 void flecs_module_init(ecs_world_t *world){
@@ -237,11 +335,99 @@ void flecs_module_init(ecs_world_t *world){
     .isCleanUpModule=false,
     .moduleCount=0
   });
+
+  ModuleRegistry reg = {0};
+  ecs_map_init(&reg.index, NULL);
+  ecs_singleton_set_ptr(world, ModuleRegistry, &reg);
+  ecs_atfini(world, flecs_module_registry_fini, NULL);
+
+  ecs_singleton_set(world, SimulationClock, {
+    .fixedStep=1.0f / 60.0f
+  });
+
+  ecs_singleton_set(world, TaskScheduler, { .pool = NULL });
+  ecs_atfini(world, flecs_module_task_pool_fini, NULL);
+
+  // before the other modules, they declare their queries at init
+  flecs_query_cache_module_init(world);
+  // before the other modules, their setup systems queue work
+  flecs_jobs_module_init(world);
+}
+//===============================================
+// FRAME, fixed step logic + one render
+//===============================================
+int32_t flecs_module_frame(ecs_world_t *world, float frameDelta, int32_t maxTicks){
+  SimulationClock *clock = ecs_singleton_get_mut(world, SimulationClock);
+  if (!clock || clock->fixedStep <= 0.0f) return 0;
+
+  // capture start / stop only between frames
+  trace_frame_begin();
+  latency_frame_begin();
+  clock->frames++;
+  clock->accumulator += frameDelta;
+  float step = clock->fixedStep;
+
+  int32_t ticks = 0;
+  while (ticks < maxTicks) {
+    clock = ecs_singleton_get_mut(world, SimulationClock);
+    if (clock->accumulator < step) break;
+    clock->accumulator -= step;
+    trace_begin("logic tick", "pipeline");
+    ecs_progress(world, step);
+    latency_mark(LATENCY_SIMULATED);
+    trace_phase_leave();
+    trace_end();
+    ticks++;
+  }
+
+  // systems may have moved the singleton
+  clock = ecs_singleton_get_mut(world, SimulationClock);
+  // still behind after the cap, drop the backlog instead of spiralling
+  if (clock->accumulator >= step) {
+    int32_t dropped = (int32_t)(clock->accumulator / step);
+    clock->droppedTicks += dropped;
+    clock->accumulator -= (float)dropped * step;
+  }
+
+  clock->ticks += ticks;
+  clock->ticksThisFrame = ticks;
+  clock->alpha = clock->accumulator / step;
+
+  // work the pool threads handed back to the window thread
+  trace_begin("main thread tasks", "pipeline");
+  task_pool_run_main(flecs_module_task_pool(world));
+  trace_end();
+
+  // nothing to draw before the setup phases ran in the first tick
+  if (ecs_get_world_info(world)->frame_count_total > 0) {
+    trace_begin("render", "pipeline");
+    ecs_run_pipeline(world, GlobalPhases.RenderPipeline, frameDelta);
+    trace_phase_leave();
+    trace_end();
+  }
+  trace_frame_end();
+  latency_frame_end();
+  return ticks;
 }
+ecs_entity_t module_find(const ecs_world_t *world, const char *name){
+  const ModuleRegistry *reg = ecs_singleton_get(world, ModuleRegistry);
+  if (!reg) return 0;
+  return module_lookup(world, reg, name, NULL);
+}
+
 //===============================================
 // ADD MODULE NAME
 //===============================================
 ecs_entity_t add_module_name(ecs_world_t *world, const char *name) {
+  ModuleRegistry *reg = ecs_singleton_get_mut(world, ModuleRegistry);
+  if (!reg) return 0;
+  uint64_t key;
+  ecs_entity_t found = module_lookup(world, reg, name, &key);
+  if (found) {
+    ecs_print(1,"[module] %s is registered already", name);
+    return found;
+  }
+
   ecs_entity_t e = ecs_new(world);
   PluginModule module = { .isCleanUp = false };
   
@@ -256,35 +442,31 @@ ecs_entity_t add_module_name(ecs_world_t *world, const char *name) {
   // Set component
   //ecs_set(world, e, PluginModule, module);
   ecs_set_id(world, e, ecs_id(PluginModule), sizeof(PluginModule), &module);
+
+  // ecs_set_id may have moved the singleton storage
+  reg = ecs_singleton_get_mut(world, ModuleRegistry);
+  ecs_map_insert(&reg->index, key, (ecs_map_val_t)e);
+  reg->count++;
+  ecs_os_ainc(&reg->pending);
+  ModuleContext *g_module = ecs_singleton_get_mut(world, ModuleContext);
+  if (g_module) g_module->moduleCount = reg->count;
   return e;
 }
 
 //===============================================
-// ADD MODULE NAME
+// BREAK MODULE NAME
 //===============================================
 void module_break_name(ecs_iter_t *it, const char *module_name){
-  // Create query for PluginModule
-  ecs_query_t *q = ecs_query(it->world, {
-    .terms = {
-      { .id = ecs_id(PluginModule) }
-    }
-  });
-
-  ecs_iter_t s_it = ecs_query_iter(it->world, q);
-  bool found = false;
-
-  while (ecs_query_next(&s_it) && !found) {
-    PluginModule *p = ecs_field(&s_it, PluginModule, 0); // 1-based index
-    for (int i = 0; i < s_it.count; i++) {
-        printf("Checking module: %s\n", p[i].name);
-        if (strcmp(p[i].name, module_name) == 0) {
-            p[i].isCleanUp = true;
-            printf("Marked %s for cleanup\n", module_name);
-            found = true;
-            break; // Exit inner loop
-        }
-    }
+  ecs_entity_t e = module_find(it->world, module_name);
+  if (!e) {
+    ecs_print(1,"[module] no module %s to clean up", module_name);
+    return;
   }
-  
+  PluginModule *p = ecs_get_mut(it->world, e, PluginModule);
+  if (!p || p->isCleanUp) return;
+  p->isCleanUp = true;
+  ModuleRegistry *reg = ecs_singleton_get_mut(it->world, ModuleRegistry);
+  if (reg) ecs_os_adec(&reg->pending);
+  printf("Marked %s for cleanup\n", module_name);
 }
 
@@ -0,0 +1,362 @@
+// per system profiler
+// callback trampoline + rolling history, only built with RL_PROFILER
+#include "flecs_module.h"
+#include "flecs_profiler.h"
+#include "flecs_trace.h"
+
+#ifdef RL_PROFILER
+
+#include <stdlib.h>
+#include <string.h>
+#include "raylib.h"
+
+typedef struct {
+  ecs_entity_t system;
+  ecs_entity_t phase;
+  char name[48];
+  char phaseName[32];
+  ecs_iter_action_t callback;           // Original system callback
+  void *callbackCtx;
+  ecs_ctx_free_t callbackCtxFree;
+  uint64_t frameNs;                     // Since the last sample
+  float samples[PROFILER_HISTORY];      // ms per displayed frame
+} ProfilerEntry;
+
+// one world per app, state lives here so systems can register before the
+// profiler module (flecs_module_init runs first)
+static struct {
+  ProfilerEntry **entries;              // Stable pointers, used as callback_ctx
+  int32_t count;
+  int32_t capacity;
+  int32_t head;
+  int32_t frames;                       // Valid samples per entry
+  bool showOverlay;
+} profiler;
+
+// main thread share only for multi threaded systems, workers would race on frameNs
+static void profiler_trampoline(ecs_iter_t *it){
+  ProfilerEntry *e = it->callback_ctx;
+  it->callback_ctx = e->callbackCtx;
+  bool isMain = ecs_stage_get_id(it->world) == 0;
+  if (isMain) trace_phase_enter(e->phase, e->phaseName);
+  trace_begin(e->name, "system");
+  uint64_t start = ecs_os_now();
+  e->callback(it);
+  if (isMain) {
+    e->frameNs += ecs_os_now() - start;
+  }
+  trace_end();
+  it->callback_ctx = e;
+}
+
+typedef struct {
+  ecs_iter_action_t callback;
+  void *callbackCtx;
+  ecs_ctx_free_t callbackCtxFree;
+  char name[48];
+} ProfilerObserver;
+
+// observers are only traced, they can fire anywhere (inside systems, at fini)
+static void profiler_observer_trampoline(ecs_iter_t *it){
+  ProfilerObserver *o = it->callback_ctx;
+  it->callback_ctx = o->callbackCtx;
+  trace_begin(o->name, "observer");
+  o->callback(it);
+  trace_end();
+  it->callback_ctx = o;
+}
+
+// observers still fire while fini deletes the entities (after the atfini
+// actions), flecs frees this with the observer itself
+static void profiler_observer_free(void *ctx){
+  ProfilerObserver *o = ctx;
+  if (o->callbackCtxFree) o->callbackCtxFree(o->callbackCtx);
+  ecs_os_free(o);
+}
+
+ecs_entity_t profiler_observer_init(ecs_world_t *world, const ecs_observer_desc_t *desc){
+  if (!desc->callback || desc->run) {
+    return ecs_observer_init(world, desc);
+  }
+
+  ProfilerObserver *o = ecs_os_calloc_t(ProfilerObserver);
+  o->callback = desc->callback;
+  o->callbackCtx = desc->callback_ctx;
+  o->callbackCtxFree = desc->callback_ctx_free;
+
+  ecs_observer_desc_t wrapped = *desc;
+  wrapped.callback = profiler_observer_trampoline;
+  wrapped.callback_ctx = o;
+  wrapped.callback_ctx_free = profiler_observer_free;
+  ecs_entity_t observer = ecs_observer_init(world, &wrapped);
+  if (!observer) {
+    ecs_os_free(o);
+    return 0;
+  }
+  const char *name = ecs_get_name(world, observer);
+  if (name) {
+    snprintf(o->name, sizeof(o->name), "%s", name);
+  } else {
+    snprintf(o->name, sizeof(o->name), "observer #%u", (uint32_t)observer);
+  }
+  return observer;
+}
+
+// systems do not run once fini started, the entries go with the world
+static void profiler_fini(ecs_world_t *world, void *ctx){
+  (void)world;
+  (void)ctx;
+  for (int32_t i = 0; i < profiler.count; i++) {
+    ProfilerEntry *e = profiler.entries[i];
+    if (e->callbackCtxFree) e->callbackCtxFree(e->callbackCtx);
+    ecs_os_free(e);
+  }
+  ecs_os_free(profiler.entries);
+  profiler.entries = NULL;
+  profiler.count = 0;
+  profiler.capacity = 0;
+  profiler.head = 0;
+  profiler.frames = 0;
+}
+
+ecs_entity_t profiler_system_init_desc(ecs_world_t *world, const ecs_system_desc_t *desc){
+  if (!desc->callback || desc->run) {
+    return ecs_system_init(world, desc);
+  }
+
+  ProfilerEntry *e = ecs_os_calloc_t(ProfilerEntry);
+  e->callback = desc->callback;
+  e->callbackCtx = desc->callback_ctx;
+  e->callbackCtxFree = desc->callback_ctx_free;
+
+  ecs_system_desc_t wrapped = *desc;
+  wrapped.callback = profiler_trampoline;
+  wrapped.callback_ctx = e;
+  // profiler_fini frees both, flecs would hand e to the caller's free
+  wrapped.callback_ctx_free = NULL;
+  ecs_entity_t system = ecs_system_init(world, &wrapped);
+  if (!system) {
+    ecs_os_free(e);
+    return 0;
+  }
+
+  e->system = system;
+  e->phase = ecs_get_target(world, system, EcsDependsOn, 0);
+  const char *name = ecs_get_name(world, system);
+  const char *phaseName = e->phase ? ecs_get_name(world, e->phase) : NULL;
+  snprintf(e->name, sizeof(e->name), "%s", name ? name : "(unnamed)");
+  if (phaseName) {
+    snprintf(e->phaseName, sizeof(e->phaseName), "%s", phaseName);
+  } else {
+    snprintf(e->phaseName, sizeof(e->phaseName), "#%u", (uint32_t)e->phase);
+  }
+
+  if (profiler.count == profiler.capacity) {
+    if (profiler.capacity == 0) ecs_atfini(world, profiler_fini, NULL);
+    profiler.capacity = profiler.capacity ? profiler.capacity * 2 : 32;
+    profiler.entries = ecs_os_realloc_n(profiler.entries, ProfilerEntry*, profiler.capacity);
+  }
+  profiler.entries[profiler.count++] = e;
+  return system;
+}
+
+int32_t profiler_count(void){
+  return profiler.count;
+}
+
+const char *profiler_name(int32_t index){
+  return profiler.entries[index]->name;
+}
+
+const char *profiler_phase_name(int32_t index){
+  return profiler.entries[index]->phaseName;
+}
+
+static int profiler_compare_float(const void *a, const void *b){
+  float x = *(const float *)a;
+  float y = *(const float *)b;
+  return (x > y) - (x < y);
+}
+
+static ProfilerSummary profiler_summarize(float *values, int32_t count){
+  ProfilerSummary s = {0};
+  if (count == 0) return s;
+  double sum = 0.0;
+  for (int32_t i = 0; i < count; i++) sum += values[i];
+  qsort(values, (size_t)count, sizeof(float), profiler_compare_float);
+  s.min = values[0];
+  s.max = values[count - 1];
+  s.avg = (float)(sum / count);
+  s.p99 = values[(int32_t)((count - 1) * 0.99f + 0.5f)];
+  return s;
+}
+
+ProfilerSummary profiler_summary(int32_t index){
+  float values[PROFILER_HISTORY];
+  memcpy(values, profiler.entries[index]->samples, sizeof(float) * (size_t)profiler.frames);
+  return profiler_summarize(values, profiler.frames);
+}
+
+static int32_t profiler_bucket(float ms){
+  float us = ms * 1000.0f;
+  int32_t b = 0;
+  for (float edge = 1.0f; us >= edge && b < PROFILER_BUCKETS - 1; edge *= 2.0f) b++;
+  return b;
+}
+
+void profiler_histogram(int32_t index, int32_t buckets[PROFILER_BUCKETS]){
+  memset(buckets, 0, sizeof(int32_t) * PROFILER_BUCKETS);
+  for (int32_t i = 0; i < profiler.frames; i++) {
+    buckets[profiler_bucket(profiler.entries[index]->samples[i])]++;
+  }
+}
+
+typedef struct {
+  int32_t index;
+  float avg;
+} ProfilerRank;
+
+static int profiler_compare_rank(const void *a, const void *b){
+  float x = ((const ProfilerRank *)a)->avg;
+  float y = ((const ProfilerRank *)b)->avg;
+  return (x < y) - (x > y);
+}
+
+int32_t profiler_sorted(int32_t *out, int32_t max){
+  if (profiler.count == 0) return 0;
+  ProfilerRank *ranks = ecs_os_malloc_n(ProfilerRank, profiler.count);
+  for (int32_t i = 0; i < profiler.count; i++) {
+    ranks[i] = (ProfilerRank){ .index = i, .avg = profiler_summary(i).avg };
+  }
+  qsort(ranks, (size_t)profiler.count, sizeof(ProfilerRank), profiler_compare_rank);
+  int32_t n = profiler.count < max ? profiler.count : max;
+  for (int32_t k = 0; k < n; k++) out[k] = ranks[k].index;
+  ecs_os_free(ranks);
+  return n;
+}
+
+void profiler_set_overlay(bool show){
+  profiler.showOverlay = show;
+}
+
+bool profiler_overlay(void){
+  return profiler.showOverlay;
+}
+
+void profiler_reset(void){
+  for (int32_t i = 0; i < profiler.count; i++) {
+    memset(profiler.entries[i]->samples, 0, sizeof(profiler.entries[i]->samples));
+    profiler.entries[i]->frameNs = 0;
+  }
+  profiler.head = 0;
+  profiler.frames = 0;
+}
+
+// phase total of one frame slot = sum of its systems
+static int32_t profiler_phase_summary(int32_t first, ProfilerSummary *out){
+  float values[PROFILER_HISTORY] = {0};
+  ecs_entity_t phase = profiler.entries[first]->phase;
+  for (int32_t i = 0; i < profiler.count; i++) {
+    if (profiler.entries[i]->phase != phase) continue;
+    if (i < first) return 0; // already counted at its first system
+    for (int32_t f = 0; f < profiler.frames; f++) {
+      values[f] += profiler.entries[i]->samples[f];
+    }
+  }
+  *out = profiler_summarize(values, profiler.frames);
+  return 1;
+}
+
+void profiler_print(void){
+  ecs_print(1, "profiler, last %d frames (ms)", profiler.frames);
+  ecs_print(1, "  phases:");
+  for (int32_t i = 0; i < profiler.count; i++) {
+    ProfilerSummary s;
+    if (!profiler_phase_summary(i, &s)) continue;
+    ecs_print(1, "  %-32s avg %8.3f p99 %8.3f max %8.3f",
+      profiler.entries[i]->phaseName, s.avg, s.p99, s.max);
+  }
+  ecs_print(1, "  systems:");
+  int32_t *order = ecs_os_malloc_n(int32_t, profiler.count > 0 ? profiler.count : 1);
+  int32_t n = profiler_sorted(order, profiler.count);
+  for (int32_t k = 0; k < n; k++) {
+    ProfilerSummary s = profiler_summary(order[k]);
+    ecs_print(1, "  %-32s avg %8.3f p99 %8.3f max %8.3f", profiler.entries[order[k]]->name, s.avg, s.p99, s.max);
+  }
+  ecs_os_free(order);
+}
+
+bool profiler_dump(const char *path){
+  FILE *f = fopen(path, "w");
+  if (!f) {
+    ecs_print(1, "[profiler] can't open %s", path);
+    return false;
+  }
+  fprintf(f, "kind,name,phase,frames,min_ms,avg_ms,p99_ms,max_ms");
+  for (int b = 0; b < PROFILER_BUCKETS - 1; b++) fprintf(f, ",lt_%dus", 1 << b);
+  fprintf(f, ",ge_%dus", 1 << (PROFILER_BUCKETS - 2));
+  fprintf(f, "\n");
+
+  for (int32_t i = 0; i < profiler.count; i++) {
+    ProfilerSummary s;
+    if (!profiler_phase_summary(i, &s)) continue;
+    fprintf(f, "phase,%s,%s,%d,%.4f,%.4f,%.4f,%.4f\n", profiler.entries[i]->phaseName,
+      profiler.entries[i]->phaseName, profiler.frames, s.min, s.avg, s.p99, s.max);
+  }
+  for (int32_t i = 0; i < profiler.count; i++) {
+    ProfilerSummary s = profiler_summary(i);
+    int32_t buckets[PROFILER_BUCKETS];
+    profiler_histogram(i, buckets);
+    fprintf(f, "system,%s,%s,%d,%.4f,%.4f,%.4f,%.4f", profiler.entries[i]->name,
+      profiler.entries[i]->phaseName, profiler.frames, s.min, s.avg, s.p99, s.max);
+    for (int b = 0; b < PROFILER_BUCKETS; b++) fprintf(f, ",%d", buckets[b]);
+    fprintf(f, "\n");
+  }
+  fclose(f);
+  ecs_print(1, "[profiler] dump %s", path);
+  return true;
+}
+
+// end of the displayed frame, the logic ticks of this frame are included
+void profiler_sample_system(ecs_iter_t *it){
+  for (int32_t i = 0; i < profiler.count; i++) {
+    ProfilerEntry *e = profiler.entries[i];
+    e->samples[profiler.head] = (float)((double)e->frameNs * 1e-6);
+    e->frameNs = 0;
+  }
+  profiler.head = (profiler.head + 1) % PROFILER_HISTORY;
+  if (profiler.frames < PROFILER_HISTORY) profiler.frames++;
+}
+
+void profiler_overlay_system(ecs_iter_t *it){
+  if (!profiler.showOverlay) return;
+
+  int32_t order[12];
+  int32_t n = profiler_sorted(order, 12);
+  int x = 10;
+  int y = GetScreenHeight() - 30 - (n + 1) * 16;
+  DrawRectangle(x - 5, y - 5, 520, (n + 1) * 16 + 10, Fade(BLACK, 0.6f));
+  DrawText("system                            avg ms   p99 ms   max ms", x, y, 10, RAYWHITE);
+  for (int32_t k = 0; k < n; k++) {
+    ProfilerSummary s = profiler_summary(order[k]);
+    DrawText(TextFormat("%-32s %8.3f %8.3f %8.3f", profiler.entries[order[k]]->name, s.avg, s.p99, s.max),
+      x, y + 16 * (k + 1), 10, RAYWHITE);
+  }
+}
+
+void flecs_profiler_module_init(ecs_world_t *world){
+  ecs_print(1, "Initializing profiler module...");
+
+  // not profiled themselves, registered last so they run after the frame
+  ecs_system_init(world, &(ecs_system_desc_t){
+    .entity = ecs_entity(world, { .name = "profiler_overlay_system", .add = ecs_ids(ecs_dependson(GlobalPhases.Render2D3Phase)) }),
+    .callback = profiler_overlay_system
+  });
+
+  ecs_system_init(world, &(ecs_system_desc_t){
+    .entity = ecs_entity(world, { .name = "profiler_sample_system", .add = ecs_ids(ecs_dependson(GlobalPhases.EndRenderPhase)) }),
+    .callback = profiler_sample_system
+  });
+}
+
+#endif
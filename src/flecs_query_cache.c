@@ -0,0 +1,123 @@
+// named query cache, declared once, freed at world fini
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "flecs_query_cache.h"
+#include "flecs_hash.h"
+
+#define QUERY_NAME_MAX (sizeof(((QueryCacheEntry *)0)->name) - 1)
+
+// FNV-1a of the stored (truncated) name. Two names with one hash: the second
+// goes to the next free key, a lookup walks the keys until the name matches
+// or a key is free.
+static QueryHandle query_cache_lookup(const QueryCache *cache, const char *name, uint64_t *freeKey){
+  uint64_t key = hash_fnv1a_str(name, QUERY_NAME_MAX);
+  for (ecs_map_val_t *h; (h = ecs_map_get(&cache->index, key)); key++) {
+    if (strncmp(cache->entries[*h - 1].name, name, QUERY_NAME_MAX) == 0) return (QueryHandle)*h;
+  }
+  if (freeKey) *freeKey = key;
+  return 0;
+}
+
+QueryHandle query_cache_find(const ecs_world_t *world, const char *name){
+  // benches build queries without flecs_module_init
+  if (!ecs_id(QueryCache)) return 0;
+  const QueryCache *cache = ecs_singleton_get(world, QueryCache);
+  return cache ? query_cache_lookup(cache, name, NULL) : 0;
+}
+
+// systems run deferred, a query made there is made every time its code path is new
+static bool query_cache_is_late(ecs_world_t *world, QueryCache *cache, const char *what){
+  if (!ecs_is_deferred(world)) return false;
+  cache->lateCount++;
+  if (cache->isDebug) {
+    ecs_print(1, "[queries] warning: %s created inside a frame (frame %lld), declare it at init",
+      what, (long long)ecs_get_world_info(world)->frame_count_total);
+  }
+  return true;
+}
+
+QueryHandle query_cache_declare(ecs_world_t *world, const char *name, const ecs_query_desc_t *desc){
+  if (!ecs_id(QueryCache)) return 0;
+  QueryCache *cache = ecs_singleton_get_mut(world, QueryCache);
+  if (!cache) return 0;
+  uint64_t key;
+  QueryHandle found = query_cache_lookup(cache, name, &key);
+  if (found) return found;
+  if (cache->count == QUERY_CACHE_MAX) {
+    ecs_print(1, "[queries] cache full, %s not declared", name);
+    return 0;
+  }
+
+  bool isLate = query_cache_is_late(world, cache, name);
+
+  ecs_query_desc_t d = *desc;
+  if (d.cache_kind == EcsQueryCacheDefault) d.cache_kind = EcsQueryCacheAuto;
+  ecs_query_t *q = ecs_query_init(world, &d);
+  if (!q) {
+    ecs_print(1, "[queries] %s failed to build", name);
+    return 0;
+  }
+
+  QueryCacheEntry *e = &cache->entries[cache->count++];
+  snprintf(e->name, sizeof(e->name), "%s", name);
+  e->query = q;
+  e->isLate = isLate;
+  QueryHandle handle = cache->count;
+  ecs_map_insert(&cache->index, key, (ecs_map_val_t)handle);
+  return handle;
+}
+
+ecs_query_t *query_cache_init_(ecs_world_t *world, const ecs_query_desc_t *desc, const char *file, int32_t line){
+  ecs_query_t *query = ecs_query_init(world, desc);
+  if (!ecs_id(QueryCache)) return query;
+  QueryCache *cache = ecs_singleton_get_mut(world, QueryCache);
+  if (!cache || !query) return query;
+  cache->directCount++;
+  char what[96];
+  snprintf(what, sizeof(what), "query at %s:%d", file, line);
+  query_cache_is_late(world, cache, what);
+  return query;
+}
+
+ecs_query_t *query_cache_get(const ecs_world_t *world, QueryHandle handle){
+  if (!ecs_id(QueryCache)) return NULL;
+  const QueryCache *cache = ecs_singleton_get(world, QueryCache);
+  if (!cache || handle <= 0 || handle > cache->count) return NULL;
+  return cache->entries[handle - 1].query;
+}
+
+void query_cache_set_debug(ecs_world_t *world, bool isDebug){
+  if (!ecs_id(QueryCache)) return;
+  QueryCache *cache = ecs_singleton_get_mut(world, QueryCache);
+  if (cache) cache->isDebug = isDebug;
+}
+
+void query_cache_print(const QueryCache *cache){
+  if (!cache) return;
+  ecs_print(1, "queries %d / %d, %d made outside the cache, %d created inside a frame, debug %s",
+    cache->count, QUERY_CACHE_MAX, cache->directCount, cache->lateCount, cache->isDebug ? "on" : "off");
+  for (int32_t i = 0; i < cache->count; i++) {
+    ecs_print(1, "  %2d %-31s%s", i + 1, cache->entries[i].name, cache->entries[i].isLate ? " (in frame)" : "");
+  }
+}
+
+static void query_cache_fini(ecs_world_t *world, void *ctx){
+  (void)ctx;
+  QueryCache *cache = ecs_singleton_get_mut(world, QueryCache);
+  if (!cache) return;
+  for (int32_t i = 0; i < cache->count; i++) {
+    ecs_query_fini(cache->entries[i].query);
+  }
+  ecs_map_fini(&cache->index);
+  cache->count = 0;
+}
+
+void flecs_query_cache_module_init(ecs_world_t *world){
+  ECS_COMPONENT_DEFINE(world, QueryCache);
+  const char *debug = getenv("RL_QUERY_DEBUG");
+  QueryCache cache = { .isDebug = debug && strcmp(debug, "0") != 0 };
+  ecs_map_init(&cache.index, NULL);
+  ecs_singleton_set_ptr(world, QueryCache, &cache);
+  ecs_atfini(world, query_cache_fini, NULL);
+}
@@ -31,7 +31,8 @@ void rg_register_components(ecs_world_t *world){
 void rg_register_systems(ecs_world_t *world){
 
   // Create an entity observer
-  ecs_observer(world, {
+  profiler_observer(world, {
+    .entity = ecs_entity(world, { .name = "OnClick" }),
     // Not interested in any specific component
     .query.terms = {{ EcsAny, .src.id = Widget }},
     .events = { ClickEvent },
@@ -1,148 +1,24 @@
 // raylib module need for handle entities
 // this set up and run time update
+#include <stdlib.h>
+#include <string.h>
 #include "flecs_module.h"
 #include "flecs_raylib.h"
+#include "flecs_transform.h"
+#include "flecs_culling.h"
+#include "flecs_render_stats.h"
+#include "flecs_input.h"
+#include "flecs_latency.h"
 
-// Helper function to update a single transform
-void UpdateTransform(ecs_world_t *world, ecs_entity_t entity, Transform3D *transform) {
-  // Get parent entity
-  ecs_entity_t parent = ecs_get_parent(world, entity);
-  const char *name = ecs_get_name(world, entity) ? ecs_get_name(world, entity) : "(unnamed)";
-  bool parentIsDirty = false;
-
-  // Check if parent is dirty
-  if (parent && ecs_is_valid(world, parent)) {
-      const Transform3D *parent_transform = ecs_get(world, parent, Transform3D);
-      if (parent_transform && parent_transform->isDirty) {
-          parentIsDirty = true;
-      }
-  }
-
-  // Skip update if neither this transform nor its parent is dirty
-  if (!transform->isDirty && !parentIsDirty) {
-      // printf("Skipping update for %s (not dirty)\n", name);
-      return;
-  }
-
-  // Compute local transform
-  Matrix translation = MatrixTranslate(transform->position.x, transform->position.y, transform->position.z);
-  Matrix rotation = QuaternionToMatrix(transform->rotation);
-  Matrix scaling = MatrixScale(transform->scale.x, transform->scale.y, transform->scale.z);
-  transform->localMatrix = MatrixMultiply(scaling, MatrixMultiply(rotation, translation));
-
-  if (!parent || !ecs_is_valid(world, parent)) {
-      // Root entity: world matrix = local matrix
-      transform->worldMatrix = transform->localMatrix;
-      // printf("Root %s position (%.2f, %.2f, %.2f)\n", name, transform->position.x, transform->position.y, transform->position.z);
-  } else {
-      // Child entity: world matrix = local matrix * parent world matrix
-      const Transform3D *parent_transform = ecs_get(world, parent, Transform3D);
-      if (!parent_transform) {
-          // printf("Error: Parent %s lacks Transform3D for %s\n",
-          //        ecs_get_name(world, parent) ? ecs_get_name(world, parent) : "(unnamed)", name);
-          transform->worldMatrix = transform->localMatrix;
-          return;
-      }
-
-      // Validate parent world matrix
-      float px = parent_transform->worldMatrix.m12;
-      float py = parent_transform->worldMatrix.m13;
-      float pz = parent_transform->worldMatrix.m14;
-      if (fabs(px) > 1e6 || fabs(py) > 1e6 || fabs(pz) > 1e6) {
-          // printf("Error: Invalid parent %s world pos (%.2f, %.2f, %.2f) for %s\n",
-          //        ecs_get_name(world, parent) ? ecs_get_name(world, parent) : "(unnamed)",
-          //        px, py, pz, name);
-          transform->worldMatrix = transform->localMatrix;
-          return;
-      }
-
-      // Compute world matrix
-      transform->worldMatrix = MatrixMultiply(transform->localMatrix, parent_transform->worldMatrix);
-
-      // Extract world position
-      float wx = transform->worldMatrix.m12;
-      float wy = transform->worldMatrix.m13;
-      float wz = transform->worldMatrix.m14;
-
-      // Debug output
-      const char *parent_name = ecs_get_name(world, parent) ? ecs_get_name(world, parent) : "(unnamed)";
-      // printf("Child %s (ID: %llu), parent %s (ID: %llu)\n",
-      //        name, (unsigned long long)entity, parent_name, (unsigned long long)parent);
-      // printf("Child %s position (%.2f, %.2f, %.2f), parent %s world pos (%.2f, %.2f, %.2f), world pos (%.2f, %.2f, %.2f)\n",
-      //        name, transform->position.x, transform->position.y, transform->position.z,
-      //        parent_name, px, py, pz, wx, wy, wz);
-  }
-
-  // Mark children as dirty to ensure they update in the next frame
-  ecs_iter_t it = ecs_children(world, entity);
-  while (ecs_children_next(&it)) {
-      for (int i = 0; i < it.count; i++) {
-          Transform3D *child_transform = ecs_get_mut(world, it.entities[i], Transform3D);
-          if (child_transform) {
-              child_transform->isDirty = true;
-              //ecs_set(world, it.entities[i], Transform3D, *child_transform);
-          }
-      }
-  }
-
-  // Reset isDirty after updating
-  transform->isDirty = false;
-}
-
-// Recursive function to process entity and its children
-void ProcessEntityHierarchy(ecs_world_t *world, ecs_entity_t entity) {
-  // Update the current entity's transform
-  Transform3D *transform = ecs_get_mut(world, entity, Transform3D);
-  bool wasUpdated = false;
-  if (transform) {
-      // Only update if dirty or parent is dirty
-      ecs_entity_t parent = ecs_get_parent(world, entity);
-      bool parentIsDirty = false;
-      if (parent && ecs_is_valid(world, parent)) {
-          const Transform3D *parent_transform = ecs_get(world, parent, Transform3D);
-          if (parent_transform && parent_transform->isDirty) {
-              parentIsDirty = true;
-          }
-      }
-      if (transform->isDirty || parentIsDirty) {
-          UpdateTransform(world, entity, transform);
-          //ecs_set(world, entity, Transform3D, *transform); // Commit changes
-          wasUpdated = true;
-      }
-  }
-
-  // Skip processing children if this entity was not updated
-  if (!wasUpdated) {
-      return;
-  }
-
-  // Iterate through children
-  ecs_iter_t it = ecs_children(world, entity);
-  while (ecs_children_next(&it)) {
-      for (int i = 0; i < it.count; i++) {
-          ecs_entity_t child = it.entities[i];
-          ProcessEntityHierarchy(world, child); // Recursively process child
-      }
-  }
-}
-
-// System to update all transforms in hierarchical order
-void UpdateTransformHierarchySystem(ecs_iter_t *it) {
-  // Process only root entities (no parent)
-  Transform3D *transforms = ecs_field(it, Transform3D, 0);
-  for (int i = 0; i < it->count; i++) {
-      ecs_entity_t entity = it->entities[i];
-      ProcessEntityHierarchy(it->world, entity);
-  }
-}
+#define RL_HEADLESS_FRAMES 600
 
 // Function to check if the model exists/loaded
-bool is_model_valid(ModelComponent* component) {
-  if (component == NULL || !component->isLoaded) {
+bool is_model_valid(const Model* model) {
+  if (model == NULL) {
       return false;
   }
   // Additional check: ensure model has valid mesh data
-  return component->model.meshCount > 0 && component->model.meshes != NULL;
+  return model->meshCount > 0 && model->meshes != NULL;
 }
 
 // Custom logging function
@@ -167,6 +43,12 @@ bool is_model_valid(ModelComponent* component) {
 void rl_setup_system(ecs_iter_t *it){
   RayLibContext *rl_ctx = ecs_singleton_ensure(it->world, RayLibContext);
   if(!rl_ctx) return;
+  if (rl_ctx->isHeadless) {
+    // no window, models are CPU only meshes
+    ecs_print(1,"setup raylib headless, %d logic ticks", rl_ctx->headlessFrames);
+    asset_registry_set_headless(it->world, true);
+    return;
+  }
   ecs_print(1,"setup raylib window");
 
   // Set custom logger
@@ -174,7 +56,18 @@ void rl_setup_system(ecs_iter_t *it){
 
   InitWindow(rl_ctx->width, rl_ctx->height, "main flecs");
   SetExitKey(KEY_NULL);  // Set no key to close window automatically
-  SetTargetFPS(60);
+  // no raylib wait in EndDrawing, the main loop paces frames (frame_pacer.c)
+  SetTargetFPS(0);
+}
+
+// frames without a logic tick keep their presses for the next one,
+// raylib clears its key queue every frame
+void rl_input_pump_system(ecs_iter_t *it){
+  const RayLibContext *rl_ctx = ecs_singleton_get(it->world, RayLibContext);
+  if (!rl_ctx || rl_ctx->isHeadless || rl_ctx->isShutDown) return;
+  InputState *in = ecs_singleton_get_mut(it->world, InputState);
+  const SimulationClock *clock = ecs_singleton_get(it->world, SimulationClock);
+  if (in && clock) input_pump(in, clock->frames);
 }
 
 void rl_input_system(ecs_iter_t *it){
@@ -186,6 +79,50 @@ void rl_input_system(ecs_iter_t *it){
   // rl_ctx->shouldQuit = IsWindowCloseRequested();//nope
   // IsWindowState(FLAG_WINDOW_HIDPI)
 
+  // snapshot for this tick, live, recorded or replayed (flecs_input.c)
+  InputState *in = ecs_singleton_get_mut(it->world, InputState);
+  if (in) {
+    const SimulationClock *clock = ecs_singleton_get(it->world, SimulationClock);
+    if (!rl_ctx->isHeadless && clock) input_pump(in, clock->frames);
+    input_update(in, !rl_ctx->isHeadless, it->delta_time);
+    // replayed ticks carry the same input as the recorded ones
+    bool hasInput = in->eventCount > 0 || in->current.mouseDelta.x != 0.0f || in->current.mouseDelta.y != 0.0f || in->current.wheel != 0.0f;
+    latency_sample(in->tick, hasInput);
+    // key edges come from the snapshot so they replay too
+    memcpy(input->down, in->current.keys, sizeof(input->down));
+    memcpy(input->pressed, in->pressed, sizeof(input->pressed));
+    memcpy(input->released, in->released, sizeof(input->released));
+
+    // one resolve per tick, game systems read actions, not key codes
+    const InputActionMap *map = ecs_singleton_get(it->world, InputActionMap);
+    PlayerInput_T *pi_ctx = ecs_singleton_ensure(it->world, PlayerInput_T);
+    if (map && pi_ctx) {
+      InputActions *a = &pi_ctx->actions;
+      input_actions_resolve(map, in, a);
+      pi_ctx->Up = a->down & INPUT_ACTION_BIT(ACTION_MOVE_FORWARD);
+      pi_ctx->Down = a->down & INPUT_ACTION_BIT(ACTION_MOVE_BACK);
+      pi_ctx->Left = a->down & INPUT_ACTION_BIT(ACTION_MOVE_LEFT);
+      pi_ctx->Right = a->down & INPUT_ACTION_BIT(ACTION_MOVE_RIGHT);
+      pi_ctx->isJump = a->pressed & INPUT_ACTION_BIT(ACTION_JUMP);
+      pi_ctx->tabPressed = a->pressed & INPUT_ACTION_BIT(ACTION_CAMERA_MODE);
+    }
+  }
+
+  if (rl_ctx->isHeadless) {
+    // nothing to poll (WindowShouldClose is true without a window), stop after headlessFrames ticks
+    // or when the replay stream ends
+    bool isReplayDone = in && in->isReplayDone;
+    if (isReplayDone || (rl_ctx->headlessFrames > 0 && ecs_get_world_info(it->world)->frame_count_total >= rl_ctx->headlessFrames)) {
+      rl_ctx->isShutDown = true;
+      ecs_print(1,"RAYLIB HEADLESS DONE!");
+      ecs_emit(it->world, &(ecs_event_desc_t) {
+        .event = ShutDownEvent,
+        .entity = ShutDownModule
+      });
+    }
+    return;
+  }
+
   if(WindowShouldClose() == true && rl_ctx->isShutDown == false){
     rl_ctx->isShutDown = true;
     ecs_print(1,"RAYLIB WINDOW CLOSE!");
@@ -194,31 +131,12 @@ void rl_input_system(ecs_iter_t *it){
       .entity = ShutDownModule
     });
   }
-
-  int key = GetKeyPressed();
-  // ecs_print(1,"PRESS %d", key);
-  if(IsKeyPressed(key)){
-    // ecs_print(1,"PRESS %d", key);
-    input->keys[key].pressed = true;
-    input->keys[key].state = true;
-    input->keys[key].current = true;
-  }
-  // get key release different from raylib.
-  for (int i = 0; i < 339; i++) {
-    if(IsKeyReleased(i)){
-      // ecs_print(1,"RELEASE %d", i);
-      input->keys[i].pressed = false;
-      input->keys[i].state = false;
-      input->keys[i].current = false;
-    }
-  }
-
 }
 
 // Render begin system
 void rl_render_begin_system(ecs_iter_t *it) {
   RayLibContext *rl_ctx = ecs_singleton_ensure(it->world, RayLibContext);
-  if(!rl_ctx || rl_ctx->isShutDown == true) return;
+  if(!rl_ctx || rl_ctx->isShutDown == true || rl_ctx->isHeadless) return;
   // printf("rl_render_begin_system\n");
   BeginDrawing();
   ClearBackground(RAYWHITE);
@@ -229,11 +147,22 @@ void rl_render_begin_system(ecs_iter_t *it) {
 void rl_begin_camera3d_system(ecs_iter_t *it) {
   //printf("rl_begin_camera3d_system\n");
   RayLibContext *rl_ctx = ecs_singleton_ensure(it->world, RayLibContext);
-  if (!rl_ctx || !rl_ctx->isCameraValid || rl_ctx->isShutDown == true) return;
+  if (!rl_ctx || !rl_ctx->isCameraValid || rl_ctx->isShutDown == true || rl_ctx->isHeadless) return;
   BeginMode3D(rl_ctx->camera);
 }
 
-//update object mesh transform
+static Matrix rl_matrix_lerp(const Matrix *a, const Matrix *b, float t){
+  const float *pa = &a->m0;
+  const float *pb = &b->m0;
+  Matrix r;
+  float *pr = &r.m0;
+  for (int k = 0; k < 16; k++) {
+    pr[k] = pa[k] + (pb[k] - pa[k]) * t;
+  }
+  return r;
+}
+
+//queue visible models with their sort key, drawn by rl_render_batch_system
 void rl_camera3d_system(ecs_iter_t *it) {
   //printf("rl_camera3d_system\n");
   RayLibContext *rl_ctx = ecs_singleton_ensure(it->world, RayLibContext);
@@ -241,35 +170,67 @@ void rl_camera3d_system(ecs_iter_t *it) {
 
   PHComponent *ph_ctx = ecs_singleton_ensure(it->world, PHComponent);
   if (!ph_ctx) return;
+
+  RenderBatcher *batch = ecs_singleton_get_mut(it->world, RenderBatcher);
+  if (!batch) return;
   
-  Transform3D *t = ecs_field(it, Transform3D, 0);
+  WorldTransform3D *t = ecs_field(it, WorldTransform3D, 0);
   ModelComponent *m = ecs_field(it, ModelComponent, 1);
+  const WorldBounds3D *b = ecs_field(it, WorldBounds3D, 2); // optional, set by the cull phase
+  const MaterialComponent *mat = ecs_field(it, MaterialComponent, 3); // optional
+  const PreviousWorldTransform3D *prev = ecs_field(it, PreviousWorldTransform3D, 4); // optional
+  const SimulationClock *clock = ecs_singleton_get(it->world, SimulationClock);
+  float alpha = clock ? clock->alpha : 1.0f;
+  float invFar = 1.0f / (float)RL_CULL_DISTANCE_FAR;
   //ecs_print(1,"count %d", it->count);
   for (int i = 0; i < it->count; i++) {
+      if (b && !b[i].isVisible) continue;
     // if (m[i].isLoaded) {
     // }else{
     //   ecs_print(1,"null");
     // }
-      if (is_model_valid(&m[i])) {
-          // Get entity name
-          const char *name = ecs_get_name(it->world, it->entities[i]);
-          Color color = RED; // Default color
-          
-          if (name) {
-              if (strcmp(name, "Cube") == 0) {
-                  color = RED;
-              } else if (strcmp(name, "Floor") == 0) {
-                  color = GRAY;
-              } else {
-                color = BLUE;
-              }
+      // NULL when the handle is empty or was released
+      // pending async loads draw as the placeholder
+      Model *model = asset_model_get_or_placeholder(it->world, m[i].handle);
+      if (is_model_valid(model)) {
+          // no MaterialComponent, same red as before
+          Color color = mat ? mat[i].tint : RED;
+          uint8_t layer = mat ? mat[i].layer : 0;
+          // between the last two ticks, element wise is close enough for one tick of motion
+          Matrix blended;
+          const Matrix *w = &t[i].worldMatrix;
+          if (prev) {
+            blended = rl_matrix_lerp(&prev[i].worldMatrix, w, alpha);
+            w = &blended;
+          }
+          // view distance, front to back inside a batch
+          float depth = Vector3Distance(rl_ctx->camera.position, (Vector3){ w->m12, w->m13, w->m14 }) * invFar;
+
+          // world matrix goes to the render queue, sorted and batched on build
+          for (int k = 0; k < model->meshCount; k++) {
+            render_batch_add(batch, &model->meshes[k], &model->materials[model->meshMaterial[k]],
+              color, layer, depth, w);
           }
-          
-          // Update model transform with world matrix from physics
-          m[i].model.transform = t[i].worldMatrix;
-          DrawModelWires(m[i].model, (Vector3){0,0,0}, 1.0f, color);
       }
   }
+}
+
+// sort the queue, one DrawMeshInstanced per group (wireframe like DrawModelWires)
+void rl_render_batch_system(ecs_iter_t *it) {
+  RayLibContext *rl_ctx = ecs_singleton_ensure(it->world, RayLibContext);
+  if (!rl_ctx || !rl_ctx->isCameraValid || rl_ctx->isShutDown == true) return;
+  RenderBatcher *batch = ecs_singleton_get_mut(it->world, RenderBatcher);
+  if (!batch) return;
+
+  render_batch_build(batch);
+  // headless, same sort and counters without the draw
+  if (rl_ctx->isHeadless) {
+    render_batch_count(batch);
+    render_batch_begin(batch);
+    return;
+  }
+  render_batch_submit(batch, true);
+  render_batch_begin(batch);
   DrawGrid(10, 1.0f);
 }
 
@@ -277,14 +238,14 @@ void rl_camera3d_system(ecs_iter_t *it) {
 void rl_end_camera3d_system(ecs_iter_t *it) {
   //printf("EndCamera3DSystem\n");
   RayLibContext *rl_ctx = ecs_singleton_ensure(it->world, RayLibContext);
-  if (!rl_ctx || !rl_ctx->isCameraValid || rl_ctx->isShutDown == true) return;
+  if (!rl_ctx || !rl_ctx->isCameraValid || rl_ctx->isShutDown == true || rl_ctx->isHeadless) return;
   EndMode3D();
 }
 
 // Render system, 2D only can't use 3D
 void rl_render2d_system(ecs_iter_t *it) {
   RayLibContext *rl_ctx = ecs_singleton_ensure(it->world, RayLibContext);
-  if (!rl_ctx || !rl_ctx->isShutDown) return;
+  if (!rl_ctx || !rl_ctx->isShutDown || rl_ctx->isHeadless) return;
   //...
   // printf("Render2DSystem\n");
   DrawFPS(10, 10);
@@ -293,33 +254,30 @@ void rl_render2d_system(ecs_iter_t *it) {
 // Render end system
 void rl_end_render_system(ecs_iter_t *it) {
   RayLibContext *rl_ctx = ecs_singleton_ensure(it->world, RayLibContext);
-  if (!rl_ctx || rl_ctx->isShutDown == true) return;
+  if (!rl_ctx || rl_ctx->isShutDown == true || rl_ctx->isHeadless) return;
   // printf("rl_end_render_system\n");
   EndDrawing();
+  // swap done and next input polled
+  latency_mark(LATENCY_PRESENT);
 }
 
 void rl_cleanup_system(ecs_world_t *world){
 
   ecs_print(1, "MODEL CLEAN UP...");
 
-  ecs_query_t *q = ecs_query(world, {
-    .terms = {
-      { .id = ecs_id(ModelComponent) },
-    }
-  });
-
-  ecs_iter_t s_it = ecs_query_iter(world, q);
-
-  while (ecs_query_next(&s_it)) {
-    ModelComponent *p = ecs_field(&s_it, ModelComponent, 0);
-    for (int i = 0; i < s_it.count; i ++) {
+  // queued unloads are dropped, asset_registry_fini unloads what they held
+  job_queue_fini(world);
+  // every shared model once, the OnRemove release after this is a no op
+  asset_registry_fini(world);
 
-      if(p[i].isLoaded){
-        UnloadModel(p[i].model);
-      }
-    }
+  RenderBatcher *batch = ecs_singleton_get_mut(world, RenderBatcher);
+  if (batch) {
+    render_batch_unload(batch);
+    render_batch_fini(batch);
   }
 
+  render_stats_fini(world);
+  transform_hierarchy_fini(world);
 }
 
 void rl_cleanup_event_system(ecs_iter_t *it){
@@ -341,12 +299,69 @@ void OnResize(ecs_iter_t *it) {
   Resize *p = it->param; // Obtain event data from it->param member
   ecs_print(1,"Resize %d x %d", p->width, p->height);
 }
+// every ModelComponent owns one model reference: a copy acquires, a move
+// takes it over, the dtor gives it back and the last one unloads the model.
+// hooks.ctx is the world.
+static void rl_model_release(const ecs_type_info_t *type_info, ModelHandle handle){
+  ecs_world_t *world = type_info->hooks.ctx;
+  // at fini asset_registry_fini unloads what is left
+  if (handle.index == 0 || ecs_is_fini(world)) return;
+  asset_model_release(world, handle);
+}
+
+ECS_CTOR(ModelComponent, ptr, {
+  ptr->handle = (ModelHandle){0};
+})
+
+ECS_DTOR(ModelComponent, ptr, {
+  rl_model_release(type_info, ptr->handle);
+  ptr->handle = (ModelHandle){0};
+})
+
+ECS_COPY(ModelComponent, dst, src, {
+  if (dst->handle.index != src->handle.index || dst->handle.generation != src->handle.generation) {
+    rl_model_release(type_info, dst->handle);
+    dst->handle = src->handle.index ? asset_model_acquire(type_info->hooks.ctx, src->handle) : src->handle;
+  }
+})
+
+ECS_MOVE(ModelComponent, dst, src, {
+  if (dst != src) {
+    rl_model_release(type_info, dst->handle);
+    dst->handle = src->handle;
+    src->handle = (ModelHandle){0};
+  }
+})
+
+void rl_model_set(ecs_world_t *world, ecs_entity_t e, ModelHandle handle){
+  ecs_set(world, e, ModelComponent, { .handle = handle });
+  asset_model_release(world, handle);
+}
+// async model became resident, OnSet again so derived state (bounds) sees it
+void rl_model_resident_system(ecs_iter_t *it){
+  const AssetRegistry *reg = ecs_singleton_get(it->world, AssetRegistry);
+  if (!reg || reg->loadStats.lastUploads == 0) return;
+  ModelComponent *m = ecs_field(it, ModelComponent, 0);
+  for (int i = 0; i < it->count; i++) {
+    if (asset_model_is_fresh(it->world, m[i].handle)) {
+      ecs_modified(it->world, it->entities[i], ModelComponent);
+    }
+  }
+}
 // register
 void rl_register_components(ecs_world_t *world){
 
   ECS_COMPONENT_DEFINE(world, ECS_RL_INPUT_T);
-  ECS_COMPONENT_DEFINE(world, Transform3D);
   ECS_COMPONENT_DEFINE(world, ModelComponent);
+  ecs_set_hooks(world, ModelComponent, {
+    .ctor = ecs_ctor(ModelComponent),
+    .dtor = ecs_dtor(ModelComponent),
+    .copy = ecs_copy(ModelComponent),
+    .move = ecs_move(ModelComponent),
+    .ctx = world
+  });
+  ECS_COMPONENT_DEFINE(world, MaterialComponent);
+  ECS_COMPONENT_DEFINE(world, RenderBatcher);
   ECS_COMPONENT_DEFINE(world, RayLibContext);
   ECS_COMPONENT_DEFINE(world, PHComponent);
   ECS_COMPONENT_DEFINE(world, PlayerInput_T);
@@ -362,14 +377,16 @@ void rl_register_components(ecs_world_t *world){
 // register systems
 void rl_register_systems(ecs_world_t *world){
 
-  ecs_observer(world, {
+  profiler_observer(world, {
+    .entity = ecs_entity(world, { .name = "rl_cleanup_event_system" }),
     // Not interested in any specific component
     .query.terms = {{ EcsAny, .src.id = CloseModule }},
     .events = { CloseEvent },
     .callback = rl_cleanup_event_system
   });
   
-  ecs_observer(world, {
+  profiler_observer(world, {
+    .entity = ecs_entity(world, { .name = "rl_close_event_system" }),
     // Not interested in any specific component
     .query.terms = {{ EcsAny, .src.id = CloseModule }},
     .events = { CloseEvent },
@@ -377,14 +394,15 @@ void rl_register_systems(ecs_world_t *world){
   });
 
   // Create an entity observer
-  ecs_observer(world, {
+  profiler_observer(world, {
+    .entity = ecs_entity(world, { .name = "OnResize" }),
     // Not interested in any specific component
     .query.terms = {{ EcsAny, .src.id = Widget }},
     .events = { ecs_id(Resize) },
     .callback = OnResize
   });
 
-  ecs_system_init(world, &(ecs_system_desc_t){
+  profiler_system_init(world, &(ecs_system_desc_t){
     .entity = ecs_entity(world, { 
         .name = "rl_setup_system", 
         .add = ecs_ids(ecs_dependson(GlobalPhases.OnSetUpPhase)) 
@@ -392,69 +410,91 @@ void rl_register_systems(ecs_world_t *world){
     .callback = rl_setup_system
   });
 
-  ecs_system_init(world, &(ecs_system_desc_t){
+  profiler_system_init(world, &(ecs_system_desc_t){
     .entity = ecs_entity(world, { .name = "rl_input_system", .add = ecs_ids(ecs_dependson(GlobalPhases.LogicUpdatePhase)) }),
     .callback = rl_input_system
   });
 
+  profiler_system_init(world, &(ecs_system_desc_t){
+    .entity = ecs_entity(world, { .name = "rl_input_pump_system", .add = ecs_ids(ecs_dependson(GlobalPhases.BeginRenderPhase)) }),
+    .callback = rl_input_pump_system
+  });
+
+  // after asset_upload_system, same phase
+  profiler_system_init(world, &(ecs_system_desc_t){
+    .entity = ecs_entity(world, { .name = "rl_model_resident_system", .add = ecs_ids(ecs_dependson(GlobalPhases.BeginRenderPhase)) }),
+    .query.terms = {{ .id = ecs_id(ModelComponent), .inout = EcsIn }},
+    .callback = rl_model_resident_system
+  });
+
   // render the screen
-  ecs_system_init(world, &(ecs_system_desc_t){
+  profiler_system_init(world, &(ecs_system_desc_t){
     .entity = ecs_entity(world, { .name = "rl_render_begin_system", .add = ecs_ids(ecs_dependson(GlobalPhases.BeginRenderPhase)) }),
     .callback = rl_render_begin_system
    });
 
    //render started for camera 3d model only
-  ecs_system_init(world, &(ecs_system_desc_t){
+  profiler_system_init(world, &(ecs_system_desc_t){
     .entity = ecs_entity(world, { .name = "rl_begin_camera3d_system", .add = ecs_ids(ecs_dependson(GlobalPhases.BeginCamera3DPhase)) }),
     .callback = rl_begin_camera3d_system
   });
 
-  ecs_system_init(world, &(ecs_system_desc_t){
+  profiler_system_init(world, &(ecs_system_desc_t){
     .entity = ecs_entity(world, { .name = "rl_camera3d_system", .add = ecs_ids(ecs_dependson(GlobalPhases.UpdateCamera3DPhase)) }),
     .query.terms = {
-      { .id = ecs_id(Transform3D), .src.id = EcsSelf },
-      { .id = ecs_id(ModelComponent), .src.id = EcsSelf }
+      { .id = ecs_id(WorldTransform3D), .src.id = EcsSelf, .inout = EcsIn },
+      { .id = ecs_id(ModelComponent), .src.id = EcsSelf, .inout = EcsIn },
+      { .id = ecs_id(WorldBounds3D), .src.id = EcsSelf, .inout = EcsIn, .oper = EcsOptional },
+      { .id = ecs_id(MaterialComponent), .src.id = EcsSelf, .inout = EcsIn, .oper = EcsOptional },
+      { .id = ecs_id(PreviousWorldTransform3D), .src.id = EcsSelf, .inout = EcsIn, .oper = EcsOptional }
     },
     .callback = rl_camera3d_system
   });
 
+  // after all tables are collected
+  profiler_system_init(world, &(ecs_system_desc_t){
+    .entity = ecs_entity(world, { .name = "rl_render_batch_system", .add = ecs_ids(ecs_dependson(GlobalPhases.UpdateCamera3DPhase)) }),
+    .callback = rl_render_batch_system
+  });
+
   //finish camera render
-  ecs_system_init(world, &(ecs_system_desc_t){
+  profiler_system_init(world, &(ecs_system_desc_t){
     .entity = ecs_entity(world, { .name = "rl_end_camera3d_system", .add = ecs_ids(ecs_dependson(GlobalPhases.EndCamera3DPhase)) }),
     .callback = rl_end_camera3d_system
   });
 
   //render 2d screen
-  ecs_system_init(world, &(ecs_system_desc_t){
+  profiler_system_init(world, &(ecs_system_desc_t){
     .entity = ecs_entity(world, { .name = "rl_render2d_system", .add = ecs_ids(ecs_dependson(GlobalPhases.Render2D1Phase)) }),
     .callback = rl_render2d_system
   });
 
   //finish render
-  ecs_system_init(world, &(ecs_system_desc_t){
+  profiler_system_init(world, &(ecs_system_desc_t){
     .entity = ecs_entity(world, { .name = "rl_end_render_system", .add = ecs_ids(ecs_dependson(GlobalPhases.EndRenderPhase)) }),
     .callback = rl_end_render_system
   });
 
-  // LogicUpdatePhase
-  ecs_system_init(world, &(ecs_system_desc_t){
-    .entity = ecs_entity(world, {
-        .name = "UpdateTransformHierarchySystem",
-        .add = ecs_ids(ecs_dependson(GlobalPhases.LogicUpdatePhase))
-    }),
-    .query.terms = {
-        { .id = ecs_id(Transform3D), .src.id = EcsSelf },
-        { .id = ecs_pair(EcsChildOf, EcsWildcard), .oper = EcsNot } // No parent
-    },
-    .callback = UpdateTransformHierarchySystem
-  });
+  // LogicUpdatePhase, flat depth ordered pass, see flecs_transform.c
+  transform_hierarchy_register_systems(world, GlobalPhases.LogicUpdatePhase);
 
 }
 // init module
 void flecs_raylib_module_init(ecs_world_t *world){
   ecs_print(1, "Initializing raylib module...");
   rl_register_components(world);
+  asset_registry_init(world);
+  RenderBatcher batch;
+  render_batch_init(&batch);
+  ecs_singleton_set_ptr(world, RenderBatcher, &batch);
+  transform_hierarchy_init(world);
+  // before rl_register_systems, rl_camera3d_system reads WorldBounds3D
+  flecs_culling_module_init(world);
+  // upload step first in BeginRenderPhase
+  asset_register_systems(world);
   rl_register_systems(world);
+  // reads RenderBatcher and CullingContext after the 3D phases
+  flecs_render_stats_module_init(world);
 
   // Adjust camera to properly view the scene
   Camera3D camera = { 0 };
@@ -464,6 +504,10 @@ void flecs_raylib_module_init(ecs_world_t *world){
   camera.fovy = 45.0f;
   camera.projection = CAMERA_PERSPECTIVE;
 
+  // RL_HEADLESS=1 runs without a window, RL_HEADLESS_FRAMES logic ticks (default 600)
+  const char *headless = getenv("RL_HEADLESS");
+  const char *headlessFrames = getenv("RL_HEADLESS_FRAMES");
+
   ecs_singleton_set(world, RayLibContext, {
     .width=800,
     .height=600,
@@ -474,9 +518,16 @@ void flecs_raylib_module_init(ecs_world_t *world){
     .isCameraValid = true,
     .isLoaded = false,
     .isCaptureMouse = false,
+    .isHeadless = headless && strcmp(headless, "0") != 0,
+    .headlessFrames = headlessFrames ? atoi(headlessFrames) : RL_HEADLESS_FRAMES,
   });
 
   ecs_singleton_set(world, ECS_RL_INPUT_T, {0});
+  flecs_input_module_init(world);
+  // a headless replay runs until the stream ends unless RL_HEADLESS_FRAMES says otherwise
+  if (!headlessFrames && ecs_singleton_get(world, InputState)->mode == INPUT_REPLAY) {
+    ecs_singleton_get_mut(world, RayLibContext)->headlessFrames = 0;
+  }
 
   ecs_singleton_set(world, PlayerInput_T, {
     .isMovementMode=true,
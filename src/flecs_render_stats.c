@@ -0,0 +1,182 @@
+// render stats
+// one RenderStatsFrame per frame, ring buffer history and summaries
+#include <stdlib.h>
+#include <string.h>
+#include "flecs_render_stats.h"
+#include "flecs_culling.h"
+
+static const char *render_stats_names[RENDER_STAT_COUNT] = {
+  "frame_ms", "draw_calls", "instances", "groups", "vertices",
+  "triangles", "material_changes", "tested", "visible", "culled"
+};
+
+const char *render_stats_field_name(RenderStatField field){
+  return field >= 0 && field < RENDER_STAT_COUNT ? render_stats_names[field] : "?";
+}
+
+float render_stats_value(const RenderStatsFrame *frame, RenderStatField field){
+  switch (field) {
+    case RENDER_STAT_FRAME_MS: return frame->frameMs;
+    case RENDER_STAT_DRAW_CALLS: return (float)frame->drawCalls;
+    case RENDER_STAT_INSTANCES: return (float)frame->instances;
+    case RENDER_STAT_GROUPS: return (float)frame->groups;
+    case RENDER_STAT_VERTICES: return (float)frame->vertices;
+    case RENDER_STAT_TRIANGLES: return (float)frame->triangles;
+    case RENDER_STAT_MATERIAL_CHANGES: return (float)frame->materialChanges;
+    case RENDER_STAT_TESTED: return (float)frame->tested;
+    case RENDER_STAT_VISIBLE: return (float)frame->visible;
+    case RENDER_STAT_CULLED: return (float)frame->culled;
+    default: return 0.0f;
+  }
+}
+
+static void render_stats_csv_row(FILE *csv, int64_t frame, const RenderStatsFrame *f){
+  fprintf(csv, "%lld,%.4f,%d,%d,%d,%d,%d,%d,%d,%d,%d\n", (long long)frame, f->frameMs,
+    f->drawCalls, f->instances, f->groups, f->vertices, f->triangles,
+    f->materialChanges, f->tested, f->visible, f->culled);
+}
+
+void render_stats_record(RenderStats *stats, const RenderStatsFrame *frame){
+  stats->last = *frame;
+  stats->history[stats->head] = *frame;
+  stats->head = (stats->head + 1) % RENDER_STATS_HISTORY;
+  if (stats->count < RENDER_STATS_HISTORY) stats->count++;
+  if (stats->csv) {
+    render_stats_csv_row(stats->csv, stats->frame, frame);
+  }
+  stats->frame++;
+}
+
+static int render_stats_compare(const void *a, const void *b){
+  float x = *(const float *)a;
+  float y = *(const float *)b;
+  return (x > y) - (x < y);
+}
+
+RenderStatSummary render_stats_summary(const RenderStats *stats, RenderStatField field){
+  RenderStatSummary s = {0};
+  if (stats->count == 0) return s;
+
+  // 256 floats, sorting a copy is cheap enough for an overlay
+  float values[RENDER_STATS_HISTORY];
+  double sum = 0.0;
+  for (int32_t i = 0; i < stats->count; i++) {
+    values[i] = render_stats_value(&stats->history[i], field);
+    sum += values[i];
+  }
+  qsort(values, (size_t)stats->count, sizeof(float), render_stats_compare);
+  int32_t p99 = (int32_t)((stats->count - 1) * 0.99f + 0.5f);
+  s.min = values[0];
+  s.max = values[stats->count - 1];
+  s.avg = (float)(sum / stats->count);
+  s.p99 = values[p99];
+  return s;
+}
+
+void render_stats_print(const RenderStats *stats){
+  ecs_print(1, "render stats, last %d frames", stats->count);
+  for (int f = 0; f < RENDER_STAT_COUNT; f++) {
+    RenderStatSummary s = render_stats_summary(stats, (RenderStatField)f);
+    ecs_print(1, "  %-16s min %10.2f avg %10.2f p99 %10.2f max %10.2f",
+      render_stats_field_name((RenderStatField)f), s.min, s.avg, s.p99, s.max);
+  }
+}
+
+bool render_stats_csv_open(RenderStats *stats, const char *path){
+  render_stats_csv_close(stats);
+  stats->csv = fopen(path, "w");
+  if (!stats->csv) {
+    ecs_print(1, "[render stats] can't open %s", path);
+    return false;
+  }
+  fprintf(stats->csv, "frame");
+  for (int f = 0; f < RENDER_STAT_COUNT; f++) {
+    fprintf(stats->csv, ",%s", render_stats_field_name((RenderStatField)f));
+  }
+  fprintf(stats->csv, "\n");
+  ecs_print(1, "[render stats] csv %s", path);
+  return true;
+}
+
+void render_stats_csv_close(RenderStats *stats){
+  if (stats->csv) {
+    fclose(stats->csv);
+    stats->csv = NULL;
+  }
+}
+
+// after the batch submit, batch and cull counters are final for this frame
+void render_stats_collect_system(ecs_iter_t *it){
+  RenderStats *stats = ecs_singleton_get_mut(it->world, RenderStats);
+  if (!stats) return;
+
+  // first collect only starts the clock
+  double elapsed = ecs_time_measure(&stats->frameTime);
+  RenderStatsFrame frame = { .frameMs = stats->frame > 0 ? (float)(elapsed * 1000.0) : 0.0f };
+  const RenderBatcher *batch = ecs_singleton_get(it->world, RenderBatcher);
+  if (batch) {
+    frame.drawCalls = batch->drawCalls;
+    frame.instances = batch->instances;
+    frame.groups = batch->groupCount;
+    frame.vertices = batch->vertices;
+    frame.triangles = batch->triangles;
+    frame.materialChanges = batch->materialChanges;
+  }
+  const CullingContext *cull = ecs_singleton_get(it->world, CullingContext);
+  if (cull) {
+    frame.tested = cull->tested;
+    frame.visible = cull->visible;
+    frame.culled = cull->culled;
+  }
+  render_stats_record(stats, &frame);
+}
+
+void render_stats_overlay_system(ecs_iter_t *it){
+  const RenderStats *stats = ecs_singleton_get(it->world, RenderStats);
+  if (!stats || !stats->showOverlay) return;
+
+  static const RenderStatField rows[] = {
+    RENDER_STAT_FRAME_MS, RENDER_STAT_DRAW_CALLS, RENDER_STAT_INSTANCES, RENDER_STAT_VERTICES,
+    RENDER_STAT_TRIANGLES, RENDER_STAT_MATERIAL_CHANGES, RENDER_STAT_VISIBLE, RENDER_STAT_CULLED
+  };
+  int rowCount = (int)(sizeof(rows) / sizeof(rows[0]));
+  int x = GetScreenWidth() - 430;
+  int y = 10;
+  DrawRectangle(x - 10, y - 5, 430, 30 + rowCount * 18, Fade(BLACK, 0.6f));
+  DrawText("stat              last     avg     p99     max", x, y, 10, RAYWHITE);
+  for (int r = 0; r < rowCount; r++) {
+    RenderStatSummary s = render_stats_summary(stats, rows[r]);
+    float last = render_stats_value(&stats->last, rows[r]);
+    DrawText(TextFormat("%-16s %7.1f %7.1f %7.1f %7.1f", render_stats_field_name(rows[r]),
+      last, s.avg, s.p99, s.max), x, y + 20 + r * 18, 10, RAYWHITE);
+  }
+}
+
+void render_stats_fini(ecs_world_t *world){
+  RenderStats *stats = ecs_singleton_get_mut(world, RenderStats);
+  if (!stats) return;
+  render_stats_csv_close(stats);
+}
+
+void render_stats_register_components(ecs_world_t *world){
+  ECS_COMPONENT_DEFINE(world, RenderStats);
+}
+
+void render_stats_register_systems(ecs_world_t *world){
+  profiler_system_init(world, &(ecs_system_desc_t){
+    .entity = ecs_entity(world, { .name = "render_stats_collect_system", .add = ecs_ids(ecs_dependson(GlobalPhases.EndCamera3DPhase)) }),
+    .callback = render_stats_collect_system
+  });
+
+  profiler_system_init(world, &(ecs_system_desc_t){
+    .entity = ecs_entity(world, { .name = "render_stats_overlay_system", .add = ecs_ids(ecs_dependson(GlobalPhases.Render2D2Phase)) }),
+    .callback = render_stats_overlay_system
+  });
+}
+
+void flecs_render_stats_module_init(ecs_world_t *world){
+  ecs_print(1, "Initializing render stats module...");
+  render_stats_register_components(world);
+  ecs_singleton_set(world, RenderStats, { .showOverlay = false });
+  render_stats_register_systems(world);
+}
@@ -0,0 +1,95 @@
+// startup timing, init steps + setup phases + lazy resources
+#include <stdio.h>
+#include "flecs_module.h"
+#include "flecs_startup.h"
+
+// one world per app, marks start before any module exists
+static StartupStats startup;
+
+static float startup_ms(uint64_t from, uint64_t to){
+  return (float)((double)(to - from) * 1e-6);
+}
+
+static void startup_add(const char *name, float ms, uint64_t now, bool isLazy){
+  if (startup.count == STARTUP_MAX_STAGES) return;
+  StartupStage *s = &startup.stages[startup.count++];
+  snprintf(s->name, sizeof(s->name), "%s", name);
+  s->ms = ms;
+  s->atMs = startup_ms(startup.start, now);
+  s->isLazy = isLazy;
+}
+
+void startup_begin(void){
+  startup = (StartupStats){0};
+  startup.start = ecs_os_now();
+  startup.last = startup.start;
+}
+
+void startup_mark(const char *name){
+  uint64_t now = ecs_os_now();
+  startup_add(name, startup_ms(startup.last, now), now, false);
+  startup.last = now;
+}
+
+void startup_first_frame(void){
+  if (startup.firstFrameMs > 0.0f) return;
+  startup_mark("first frame");
+  startup.firstFrameMs = startup_ms(startup.start, startup.last);
+  startup_print();
+}
+
+bool startup_is_done(void){
+  return startup.firstFrameMs > 0.0f;
+}
+
+void startup_lazy_declare(StartupLazy *lazy){
+  if (!lazy->isDone) startup.lazyPending++;
+}
+
+void startup_lazy_ensure(ecs_world_t *world, StartupLazy *lazy){
+  if (lazy->isDone) return;
+  // set first, init may use the resource it builds
+  lazy->isDone = true;
+  uint64_t start = ecs_os_now();
+  lazy->init(world, lazy->ctx);
+  uint64_t now = ecs_os_now();
+  startup_add(lazy->name, startup_ms(start, now), now, true);
+  if (startup.lazyPending > 0) startup.lazyPending--;
+  ecs_print(1, "[startup] lazy %s %.3f ms", lazy->name, startup_ms(start, now));
+}
+
+const StartupStats *startup_stats(void){
+  return &startup;
+}
+
+void startup_print(void){
+  ecs_print(1, "startup, time to first frame %.3f ms", startup.firstFrameMs);
+  for (int32_t i = 0; i < startup.count; i++) {
+    const StartupStage *s = &startup.stages[i];
+    ecs_print(1, "  %-5s %-32s %9.3f ms  at %9.3f ms", s->isLazy ? "lazy" : "", s->name, s->ms, s->atMs);
+  }
+  if (startup.lazyPending > 0) ecs_print(1, "  %d lazy not built yet", startup.lazyPending);
+}
+
+// ctx = stage name
+static void startup_phase_mark_system(ecs_iter_t *it){
+  startup_mark(it->ctx);
+}
+
+void flecs_startup_module_init(ecs_world_t *world){
+  ecs_entity_t phases[] = {
+    GlobalPhases.OnSetUpPhase, GlobalPhases.OnSetupGraphicPhase,
+    GlobalPhases.OnSetupModulePhase, GlobalPhases.OnSetupWorldPhase
+  };
+  static const char *names[] = {
+    "OnSetUpPhase", "OnSetupGraphicPhase", "OnSetupModulePhase", "OnSetupWorldPhase"
+  };
+  for (size_t i = 0; i < sizeof(phases) / sizeof(phases[0]); i++) {
+    // not profiled, newest entity so it runs last in its phase
+    ecs_system_init(world, &(ecs_system_desc_t){
+      .entity = ecs_entity(world, { .add = ecs_ids(ecs_dependson(phases[i])) }),
+      .callback = startup_phase_mark_system,
+      .ctx = (void *)names[i]
+    });
+  }
+}
@@ -0,0 +1,258 @@
+// timeline capture, chrome trace event json
+// per thread event buffers, only built with RL_PROFILER
+#include "flecs_module.h"
+#include "flecs_trace.h"
+
+#ifdef RL_PROFILER
+
+#include <stdlib.h>
+#include <string.h>
+
+// one writer per buffer: the event is stored, then count is published with
+// a release store. The dump loads count with acquire and only reads below it,
+// so it can run while other threads still write.
+// A new capture bumps trace.generation, each thread empties its own buffer
+// on its next push (count before generation), nobody else touches count.
+#if defined(_MSC_VER)
+  #include <intrin.h>
+  static int32_t trace_load(const int32_t *v){
+    return (int32_t)_InterlockedCompareExchange((volatile long *)v, 0, 0);
+  }
+  static void trace_store(int32_t *v, int32_t value){
+    _InterlockedExchange((volatile long *)v, value);
+  }
+#else
+  static int32_t trace_load(const int32_t *v){
+    return __atomic_load_n(v, __ATOMIC_ACQUIRE);
+  }
+  static void trace_store(int32_t *v, int32_t value){
+    __atomic_store_n(v, value, __ATOMIC_RELEASE);
+  }
+#endif
+
+typedef struct {
+  ecs_os_thread_id_t id;
+  int32_t isReady;                              // id and events are set, trace_store
+  TraceEvent *events;
+  int32_t count;                                // trace_store / trace_load
+  int32_t dropped;                              // trace_store / trace_load
+  int32_t generation;                           // Capture the events belong to, trace_store / trace_load
+} TraceThread;
+
+// one world per app, like the profiler
+static struct {
+  TraceThread threads[TRACE_MAX_THREADS];
+  int32_t threadCount;                          // Slots taken, ecs_os_ainc
+  int32_t generation;                           // Captures started, ecs_os_ainc
+  int32_t isCapturing;                          // Read by every pushing thread, trace_store / trace_load
+  bool isStartPending;
+  bool isStopPending;
+  char stopPath[256];
+  uint64_t startNs;
+  int64_t frames;
+  ecs_entity_t phase;                           // Open phase on the main thread, 0 = none
+  ecs_os_thread_id_t mainThread;
+} trace;
+
+// the few threads that ever traced, scanned by id
+static TraceThread *trace_thread(void){
+  ecs_os_thread_id_t self = ecs_os_thread_self();
+  int32_t count = trace_load(&trace.threadCount);
+  if (count > TRACE_MAX_THREADS) count = TRACE_MAX_THREADS;
+  for (int32_t i = 0; i < count; i++) {
+    TraceThread *t = &trace.threads[i];
+    if (trace_load(&t->isReady) && t->id == self) return t;
+  }
+  int32_t slot = ecs_os_ainc(&trace.threadCount) - 1;
+  if (slot >= TRACE_MAX_THREADS) return NULL;
+  TraceThread *t = &trace.threads[slot];
+  t->events = ecs_os_malloc_n(TraceEvent, TRACE_BUFFER_EVENTS);
+  t->id = self;
+  trace_store(&t->isReady, 1);
+  return t;
+}
+
+// buffer of an older capture, empty for the current one
+static bool trace_thread_is_current(const TraceThread *t){
+  return trace_load(&t->isReady) && trace_load(&t->generation) == trace_load(&trace.generation);
+}
+
+static void trace_push(char ph, const char *name, const char *cat){
+  if (!trace_load(&trace.isCapturing)) return;
+  TraceThread *t = trace_thread();
+  if (!t) return;
+  // owning thread, the only writer of count, plain reads of its own fields
+  int32_t generation = trace_load(&trace.generation);
+  if (t->generation != generation) {
+    // emptied before the generation says current
+    trace_store(&t->count, 0);
+    trace_store(&t->dropped, 0);
+    trace_store(&t->generation, generation);
+  }
+  int32_t c = t->count;
+  if (c >= TRACE_BUFFER_EVENTS) {
+    trace_store(&t->dropped, t->dropped + 1);
+    return;
+  }
+  t->events[c] = (TraceEvent){ .name = name, .cat = cat, .ts = ecs_os_now(), .ph = ph };
+  // publish, the event is visible to an acquire load of count
+  trace_store(&t->count, c + 1);
+}
+
+void trace_begin(const char *name, const char *cat){
+  trace_push('B', name, cat);
+}
+
+void trace_end(void){
+  trace_push('E', NULL, NULL);
+}
+
+void trace_phase_enter(ecs_entity_t phase, const char *name){
+  if (!trace_load(&trace.isCapturing) || phase == trace.phase) return;
+  if (trace.phase) trace_push('E', NULL, NULL);
+  trace_push('B', name, "phase");
+  trace.phase = phase;
+}
+
+void trace_phase_leave(void){
+  if (!trace.phase) return;
+  trace_push('E', NULL, NULL);
+  trace.phase = 0;
+}
+
+void trace_frame_begin(void){
+  if (trace.isStartPending) {
+    trace.isStartPending = false;
+    // workers may still be pushing, their buffers empty on their own thread
+    ecs_os_ainc(&trace.generation);
+    trace.frames = 0;
+    trace.phase = 0;
+    trace.startNs = ecs_os_now();
+    trace_store(&trace.isCapturing, 1);
+    ecs_print(1, "[trace] capture started");
+  }
+  if (!trace_load(&trace.isCapturing)) return;
+  trace.frames++;
+  trace_push('B', "frame", "frame");
+}
+
+void trace_frame_end(void){
+  if (!trace_load(&trace.isCapturing)) return;
+  trace_phase_leave();
+  trace_push('E', NULL, NULL);
+  if (trace.isStopPending) {
+    trace.isStopPending = false;
+    trace_store(&trace.isCapturing, 0);
+    ecs_print(1, "[trace] capture stopped, %lld frames", (long long)trace.frames);
+    if (trace.stopPath[0]) trace_dump(trace.stopPath);
+  }
+}
+
+void trace_start(void){
+  trace.isStartPending = true;
+  trace.isStopPending = false;
+}
+
+void trace_stop(const char *path){
+  trace.isStartPending = false;
+  if (!trace_load(&trace.isCapturing)) return;
+  trace.isStopPending = true;
+  snprintf(trace.stopPath, sizeof(trace.stopPath), "%s", path ? path : "");
+}
+
+bool trace_is_capturing(void){
+  return trace_load(&trace.isCapturing) || trace.isStartPending;
+}
+
+// names are system / entity names and literals, only " and \ need escaping
+static void trace_write_string(FILE *f, const char *s){
+  fputc('"', f);
+  for (; s && *s; s++) {
+    if (*s == '"' || *s == '\\') fputc('\\', f);
+    if ((unsigned char)*s >= 0x20) fputc(*s, f);
+  }
+  fputc('"', f);
+}
+
+bool trace_dump(const char *path){
+  FILE *f = fopen(path, "w");
+  if (!f) {
+    ecs_print(1, "[trace] can't open %s", path);
+    return false;
+  }
+  int32_t count = trace_load(&trace.threadCount);
+  if (count > TRACE_MAX_THREADS) count = TRACE_MAX_THREADS;
+
+  int64_t written = 0;
+  bool isFirst = true;
+  fprintf(f, "{\"traceEvents\":[\n");
+  for (int32_t i = 0; i < count; i++) {
+    const TraceThread *t = &trace.threads[i];
+    if (!trace_thread_is_current(t)) continue;
+    int32_t n = trace_load(&t->count);
+    fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s %d\"}}",
+      isFirst ? "" : ",\n", i, t->id == trace.mainThread ? "main" : "thread", i);
+    isFirst = false;
+    for (int32_t k = 0; k < n; k++) {
+      const TraceEvent *e = &t->events[k];
+      double us = e->ts > trace.startNs ? (double)(e->ts - trace.startNs) * 1e-3 : 0.0;
+      fprintf(f, ",\n{\"ph\":\"%c\",\"pid\":1,\"tid\":%d,\"ts\":%.3f", e->ph, i, us);
+      if (e->ph == 'B') {
+        fprintf(f, ",\"name\":");
+        trace_write_string(f, e->name);
+        fprintf(f, ",\"cat\":");
+        trace_write_string(f, e->cat ? e->cat : "user");
+      }
+      fprintf(f, "}");
+    }
+    written += n;
+  }
+  fprintf(f, "\n],\"displayTimeUnit\":\"ms\"}\n");
+  fclose(f);
+  ecs_print(1, "[trace] dump %s, %lld events", path, (long long)written);
+  return true;
+}
+
+TraceStats trace_stats(void){
+  TraceStats s = { .isCapturing = trace_load(&trace.isCapturing) != 0, .frames = trace.frames };
+  int32_t count = trace_load(&trace.threadCount);
+  if (count > TRACE_MAX_THREADS) count = TRACE_MAX_THREADS;
+  for (int32_t i = 0; i < count; i++) {
+    if (!trace_thread_is_current(&trace.threads[i])) continue;
+    s.events += trace_load(&trace.threads[i].count);
+    s.dropped += trace_load(&trace.threads[i].dropped);
+  }
+  s.threads = count;
+  return s;
+}
+
+void trace_print(void){
+  TraceStats s = trace_stats();
+  ecs_print(1, "trace %s, %lld frames, %lld events on %d threads, %lld dropped",
+    s.isCapturing ? "capturing" : "idle", (long long)s.frames,
+    (long long)s.events, s.threads, (long long)s.dropped);
+}
+
+// task pool workers are joined before (flecs_module_init registered first)
+static void trace_fini(ecs_world_t *world, void *ctx){
+  (void)world;
+  (void)ctx;
+  trace_store(&trace.isCapturing, 0);
+  trace.isStartPending = false;
+  int32_t count = trace_load(&trace.threadCount);
+  if (count > TRACE_MAX_THREADS) count = TRACE_MAX_THREADS;
+  for (int32_t i = 0; i < count; i++) {
+    ecs_os_free(trace.threads[i].events);
+  }
+  memset(trace.threads, 0, sizeof(trace.threads));
+  trace.threadCount = 0;
+}
+
+void flecs_trace_module_init(ecs_world_t *world){
+  ecs_print(1, "Initializing trace module...");
+  trace.mainThread = ecs_os_thread_self();
+  ecs_atfini(world, trace_fini, NULL);
+  if (getenv("TRACE_CAPTURE")) trace_start();
+}
+
+#endif
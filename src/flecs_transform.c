@@ -0,0 +1,610 @@
+// transform hierarchy propagation
+// keeps a flat depth sorted array of (entity, parent index) and computes
+// world matrices in one linear pass. rebuild only when hierarchy changes.
+#include "flecs_module.h"
+#include "flecs_transform.h"
+#include "transform_kernel.h"
+#include "flecs_profiler.h"
+#include "flecs_latency.h"
+
+// root transforms per task pool chunk
+#ifndef TRANSFORM_COMPOSE_GRAIN
+  #define TRANSFORM_COMPOSE_GRAIN 8192
+#endif
+
+// Grow node arrays to hold count nodes
+static void transform_hierarchy_reserve(TransformHierarchy *th, int32_t count){
+  if (count <= th->capacity) return;
+  int32_t capacity = th->capacity ? th->capacity : 64;
+  while (capacity < count) {
+    capacity *= 2;
+  }
+  th->entities = ecs_os_realloc_n(th->entities, ecs_entity_t, capacity);
+  th->parents = ecs_os_realloc_n(th->parents, int32_t, capacity);
+  th->localRefs = ecs_os_realloc_n(th->localRefs, ecs_ref_t, capacity);
+  th->worldRefs = ecs_os_realloc_n(th->worldRefs, ecs_ref_t, capacity);
+  th->dirty = ecs_os_realloc_n(th->dirty, bool, capacity);
+  th->world = ecs_os_realloc_n(th->world, Matrix, capacity);
+  th->updated = ecs_os_realloc_n(th->updated, bool, capacity);
+  th->gatherPos = ecs_os_realloc_n(th->gatherPos, Vector3, capacity);
+  th->gatherRot = ecs_os_realloc_n(th->gatherRot, Quaternion, capacity);
+  th->gatherScale = ecs_os_realloc_n(th->gatherScale, Vector3, capacity);
+  th->gatherLocal = ecs_os_realloc_n(th->gatherLocal, Matrix, capacity);
+  th->gatherIndex = ecs_os_realloc_n(th->gatherIndex, int32_t, capacity);
+  th->capacity = capacity;
+}
+
+// Rebuild the flat node list from all LocalTransform3D entities
+void transform_hierarchy_rebuild(ecs_world_t *world, TransformHierarchy *th){
+  int32_t count = 0;
+  int32_t nodes_capacity = 64;
+  ecs_entity_t *nodes = ecs_os_malloc_n(ecs_entity_t, nodes_capacity);
+
+  // entity -> gather position
+  ecs_map_t index;
+  ecs_map_init(&index, NULL);
+
+  ecs_iter_t it = ecs_query_iter(world, th->query);
+  while (ecs_query_next(&it)) {
+    if (count + it.count > nodes_capacity) {
+      while (count + it.count > nodes_capacity) {
+        nodes_capacity *= 2;
+      }
+      nodes = ecs_os_realloc_n(nodes, ecs_entity_t, nodes_capacity);
+    }
+    for (int i = 0; i < it.count; i++) {
+      nodes[count] = it.entities[i];
+      ecs_map_insert(&index, it.entities[i], (ecs_map_val_t)count);
+      count++;
+    }
+  }
+
+  int32_t *parent_pos = ecs_os_malloc_n(int32_t, count + 1);
+  int32_t *depth = ecs_os_malloc_n(int32_t, count + 1);
+  int32_t *chain = ecs_os_malloc_n(int32_t, count + 1);
+  int32_t *root = ecs_os_malloc_n(int32_t, count + 1);
+
+  // Parent lookup once per node, parents without LocalTransform3D count as root
+  // (-2, not matched by the root query so composed in the gather pass)
+  for (int32_t i = 0; i < count; i++) {
+    ecs_entity_t parent = ecs_get_parent(world, nodes[i]);
+    ecs_map_val_t *p = parent ? ecs_map_get(&index, parent) : NULL;
+    parent_pos[i] = p ? (int32_t)*p : (parent ? -2 : -1);
+    depth[i] = -1;
+  }
+
+  // Depth and root of each node, walk up until a known depth then unwind
+  int32_t max_depth = 0;
+  for (int32_t i = 0; i < count; i++) {
+    if (depth[i] >= 0) continue;
+    int32_t len = 0;
+    int32_t n = i;
+    while (n >= 0 && depth[n] < 0) {
+      chain[len++] = n;
+      n = parent_pos[n];
+    }
+    int32_t d = n >= 0 ? depth[n] : -1;
+    int32_t top = n >= 0 ? root[n] : chain[len - 1];
+    while (len > 0) {
+      d++;
+      depth[chain[--len]] = d;
+      root[chain[len]] = top;
+    }
+    if (d > max_depth) max_depth = d;
+  }
+
+  // Split root subtrees into partitions of about the same node count,
+  // root[] is reused as the partition of a node
+  int32_t partitions = th->partitionCount > 1 ? th->partitionCount : 1;
+  int32_t *size = ecs_os_calloc_n(int32_t, count + 1);
+  for (int32_t i = 0; i < count; i++) {
+    size[root[i]]++;
+  }
+  int32_t target = (count + partitions - 1) / partitions;
+  int32_t group = 0;
+  int32_t filled = 0;
+  for (int32_t i = 0; i < count; i++) {
+    if (depth[i] != 0) continue;
+    filled += size[i];
+    size[i] = group;
+    if (filled >= target * (group + 1) && group < partitions - 1) group++;
+  }
+  for (int32_t i = 0; i < count; i++) {
+    root[i] = size[root[i]];
+  }
+
+  // Counting sort by (partition, depth), chain is reused as the new position of a node
+  int32_t levels = max_depth + 1;
+  int32_t *offsets = ecs_os_calloc_n(int32_t, partitions * levels + 1);
+  for (int32_t i = 0; i < count; i++) {
+    offsets[root[i] * levels + depth[i] + 1]++;
+  }
+  for (int32_t b = 0; b < partitions * levels; b++) {
+    offsets[b + 1] += offsets[b];
+  }
+  transform_hierarchy_reserve(th, count);
+  for (int32_t g = 0; g < partitions; g++) {
+    th->partitionBegin[g] = offsets[g * levels];
+    th->partitionEnd[g] = offsets[(g + 1) * levels];
+  }
+  for (int32_t i = 0; i < count; i++) {
+    chain[i] = offsets[root[i] * levels + depth[i]]++;
+  }
+
+  for (int32_t i = 0; i < count; i++) {
+    int32_t n = chain[i];
+    th->entities[n] = nodes[i];
+    th->parents[n] = parent_pos[i] >= 0 ? chain[parent_pos[i]] : parent_pos[i];
+    th->localRefs[n] = ecs_ref_init(world, nodes[i], LocalTransform3D);
+    th->worldRefs[n] = ecs_ref_init(world, nodes[i], WorldTransform3D);
+    th->world[n] = MatrixIdentity();
+    th->updated[n] = false;
+    th->dirty[n] = false;
+    // index now maps to the sorted node position, kept for change detection
+    *ecs_map_ensure(&index, nodes[i]) = (ecs_map_val_t)n;
+  }
+  th->count = count;
+  th->isDirty = false;
+  // new or reparented nodes need their world matrix recomputed
+  th->isFullUpdate = true;
+  th->rebuildCount++;
+
+  ecs_os_free(offsets);
+  ecs_os_free(size);
+  ecs_os_free(root);
+  ecs_os_free(chain);
+  ecs_os_free(depth);
+  ecs_os_free(parent_pos);
+  ecs_os_free(nodes);
+  if (ecs_map_is_init(&th->index)) {
+    ecs_map_fini(&th->index);
+  }
+  th->index = index;
+}
+
+// Local TRS to matrix, same order as raylib: scale * rotation * translation
+Matrix transform_local_matrix(const LocalTransform3D *local){
+  Matrix m;
+  transform_compose_scalar(local->position, local->rotation, local->scale, &m);
+  return m;
+}
+
+// Mark the nodes of every LocalTransform3D table that changed since the last
+// frame. Returns false without touching any table when nothing changed.
+static bool transform_hierarchy_collect_changes(ecs_world_t *world, TransformHierarchy *th){
+  if (!ecs_query_changed(th->changeQuery)) return false;
+  bool any = false;
+  ecs_iter_t it = ecs_query_iter(world, th->changeQuery);
+  while (ecs_query_next(&it)) {
+    if (!ecs_iter_changed(&it)) continue;
+    any = true;
+    for (int i = 0; i < it.count; i++) {
+      ecs_map_val_t *n = ecs_map_get(&th->index, it.entities[i]);
+      if (n) th->dirty[*n] = true;
+    }
+  }
+  return any;
+}
+
+typedef struct {
+  const LocalTransform3D *local;
+  WorldTransform3D *w;
+} TransformComposeJob;
+
+static void transform_compose_range(void *ctx, int32_t begin, int32_t end, int32_t worker){
+  (void)worker;
+  const TransformComposeJob *job = ctx;
+  transform_compose_batch_strided(
+    &job->local[begin].position, sizeof(LocalTransform3D),
+    &job->local[begin].rotation, sizeof(LocalTransform3D),
+    &job->local[begin].scale, sizeof(LocalTransform3D),
+    &job->w[begin].worldMatrix, end - begin);
+}
+
+// Root tables: world matrix = local matrix, run the batch kernel straight on
+// the LocalTransform3D / WorldTransform3D columns. Only changed tables are
+// composed, as a whole, big ones in chunks over the task pool.
+static void transform_hierarchy_compose_roots(ecs_world_t *world, TransformHierarchy *th, bool full){
+  TaskPool *pool = flecs_module_task_pool(world);
+  ecs_iter_t it = ecs_query_iter(world, th->rootQuery);
+  while (ecs_query_next(&it)) {
+    if (!full && !ecs_iter_changed(&it)) {
+      // WorldTransform3D column not written, keep it unchanged
+      ecs_iter_skip(&it);
+      continue;
+    }
+    TransformComposeJob job = {
+      .local = ecs_field(&it, LocalTransform3D, 0),
+      .w = ecs_field(&it, WorldTransform3D, 1)
+    };
+    task_pool_parallel_for(pool, it.count, TRANSFORM_COMPOSE_GRAIN, transform_compose_range, &job);
+  }
+}
+
+// Linear pass over depth sorted nodes, parent world is always computed first.
+// Only the 1 byte dirty state is read for nodes that do not change.
+// Pass A picks the nodes to update and gathers their TRS, pass B composes the
+// gathered local matrices in one batch, pass C multiplies by the parent world.
+// Safe to run on worker threads for disjoint partitions, only node arrays in
+// [begin, end) are written.
+void transform_hierarchy_propagate_range(ecs_world_t *world, TransformHierarchy *th,
+  int32_t begin, int32_t end, bool full){
+  int32_t gathered = begin;
+  for (int32_t i = begin; i < end; i++) {
+    int32_t parent = th->parents[i];
+    bool parentUpdated = parent >= 0 && th->updated[parent];
+    bool dirty = th->dirty[i];
+    th->dirty[i] = false;
+    th->updated[i] = false;
+
+    // Skip update if neither this transform nor its parent is dirty
+    if (!full && !dirty && !parentUpdated) continue;
+    th->updated[i] = true;
+
+    if (parent == -1) {
+      // Root entity: already composed by the column pass
+      const WorldTransform3D *w = ecs_ref_get(world, &th->worldRefs[i], WorldTransform3D);
+      th->world[i] = w ? w->worldMatrix : MatrixIdentity();
+      continue;
+    }
+
+    const LocalTransform3D *local = ecs_ref_get(world, &th->localRefs[i], LocalTransform3D);
+    if (!local) {
+      th->updated[i] = false;
+      continue;
+    }
+    th->gatherPos[gathered] = local->position;
+    th->gatherRot[gathered] = local->rotation;
+    th->gatherScale[gathered] = local->scale;
+    th->gatherIndex[gathered] = i;
+    gathered++;
+  }
+
+  transform_compose_batch(&th->gatherPos[begin], &th->gatherRot[begin], &th->gatherScale[begin],
+    &th->gatherLocal[begin], gathered - begin);
+
+  // gather order is node order, so parents are still written before children
+  for (int32_t g = begin; g < gathered; g++) {
+    int32_t i = th->gatherIndex[g];
+    int32_t parent = th->parents[i];
+    if (parent >= 0) {
+      // Child entity: world matrix = local matrix * parent world matrix
+      transform_matrix_multiply(&th->gatherLocal[g], &th->world[parent], &th->world[i]);
+    } else {
+      // Parent has no transform, world matrix = local matrix
+      th->world[i] = th->gatherLocal[g];
+    }
+    WorldTransform3D *w = ecs_ref_get(world, &th->worldRefs[i], WorldTransform3D);
+    if (w) w->worldMatrix = th->world[i];
+  }
+}
+
+// Child world matrices are written through refs, which does not mark the
+// WorldTransform3D column changed. Main thread, after the pass: iterate the
+// child tables with an Out term, a table with an updated node is marked
+// changed, the others are skipped.
+static void transform_hierarchy_mark_changed(ecs_world_t *world, TransformHierarchy *th){
+  ecs_iter_t it = ecs_query_iter(world, th->childQuery);
+  while (ecs_query_next(&it)) {
+    bool any = false;
+    for (int i = 0; i < it.count && !any; i++) {
+      ecs_map_val_t *n = ecs_map_get(&th->index, it.entities[i]);
+      any = n && th->updated[*n];
+    }
+    if (!any) ecs_iter_skip(&it);
+  }
+}
+
+void transform_hierarchy_propagate(ecs_world_t *world, TransformHierarchy *th){
+  bool full = th->isFullUpdate;
+  bool changed = transform_hierarchy_collect_changes(world, th);
+  // static world, nothing to do
+  if (!full && !changed) return;
+  transform_hierarchy_compose_roots(world, th, full);
+  transform_hierarchy_propagate_range(world, th, 0, th->count, full);
+  transform_hierarchy_mark_changed(world, th);
+  th->isFullUpdate = false;
+}
+
+// Rebuild if needed then propagate
+void transform_hierarchy_update(ecs_world_t *world){
+  TransformHierarchy *th = ecs_singleton_ensure(world, TransformHierarchy);
+  if (!th) return;
+  if (th->isDirty) {
+    transform_hierarchy_rebuild(world, th);
+  }
+  transform_hierarchy_propagate(world, th);
+}
+
+// Main thread part of the update. With partitions the roots are composed here
+// and the node ranges are left to TransformPartitionSystem on the workers.
+void UpdateTransformHierarchySystem(ecs_iter_t *it){
+  ecs_world_t *world = it->world;
+  TransformHierarchy *th = ecs_singleton_ensure(world, TransformHierarchy);
+  if (!th) return;
+  if (th->partitionCount <= 1) {
+    transform_hierarchy_update(world);
+    return;
+  }
+  if (th->isDirty) {
+    transform_hierarchy_rebuild(world, th);
+  }
+  th->passFull = th->isFullUpdate;
+  th->isFullUpdate = false;
+  th->passActive = transform_hierarchy_collect_changes(world, th) || th->passFull;
+  if (!th->passActive) return;
+  transform_hierarchy_compose_roots(world, th, th->passFull);
+}
+
+// multi_threaded, every worker gets its share of the partition entities.
+// The workers write WorldTransform3D in place through refs on the real world,
+// not through their stage. That is safe because:
+// - each partition is a disjoint node range (whole root subtrees), no two
+//   workers write the same entity or read a node another one writes
+// - nothing is added, removed or set, so no table or column moves mid pass
+//   (the refs were resolved at rebuild, on the main thread)
+// - no system reads WorldTransform3D during the pass, and change tracking
+//   is done after it on the main thread by TransformChangedSystem
+void TransformPartitionSystem(ecs_iter_t *it){
+  const TransformPartition *p = ecs_field(it, TransformPartition, 0);
+  TransformHierarchy *th = ecs_field(it, TransformHierarchy, 1);
+  if (th->partitionCount <= 1 || !th->passActive) return;
+  ecs_world_t *world = (ecs_world_t *)ecs_get_world(it->world);
+  for (int i = 0; i < it->count; i++) {
+    int32_t g = p[i].index;
+    if (g >= th->partitionCount) continue;
+    transform_hierarchy_propagate_range(world, th, th->partitionBegin[g], th->partitionEnd[g], th->passFull);
+  }
+}
+
+// main thread, after the partitions: mark the child tables they wrote
+static void TransformChangedSystem(ecs_iter_t *it){
+  ecs_world_t *world = it->world;
+  TransformHierarchy *th = ecs_singleton_ensure(world, TransformHierarchy);
+  if (!th || th->partitionCount <= 1 || !th->passActive) return;
+  transform_hierarchy_mark_changed(world, th);
+}
+
+// after the partitions, end of the transform pass for the latency stamps
+static void TransformLatencySystem(ecs_iter_t *it){
+  (void)it;
+  latency_mark(LATENCY_TRANSFORM);
+}
+
+// keep the last tick for render interpolation, before propagation overwrites it
+void StorePreviousTransformSystem(ecs_iter_t *it){
+  const WorldTransform3D *w = ecs_field(it, WorldTransform3D, 0);
+  PreviousWorldTransform3D *p = ecs_field(it, PreviousWorldTransform3D, 1);
+  for (int i = 0; i < it->count; i++) {
+    p[i].worldMatrix = w[i].worldMatrix;
+  }
+}
+
+void transform_hierarchy_register_systems(ecs_world_t *world, ecs_entity_t phase){
+  profiler_system_init(world, &(ecs_system_desc_t){
+    .entity = ecs_entity(world, {
+        .name = "StorePreviousTransformSystem",
+        .add = ecs_ids(ecs_dependson(phase))
+    }),
+    .query.terms = {
+      { .id = ecs_id(WorldTransform3D), .inout = EcsIn },
+      { .id = ecs_id(PreviousWorldTransform3D), .inout = EcsOut }
+    },
+    .callback = StorePreviousTransformSystem
+  });
+
+  profiler_system_init(world, &(ecs_system_desc_t){
+    .entity = ecs_entity(world, {
+        .name = "UpdateTransformHierarchySystem",
+        .add = ecs_ids(ecs_dependson(phase))
+    }),
+    .callback = UpdateTransformHierarchySystem
+  });
+
+  profiler_system_init(world, &(ecs_system_desc_t){
+    .entity = ecs_entity(world, {
+        .name = "TransformPartitionSystem",
+        .add = ecs_ids(ecs_dependson(phase))
+    }),
+    .query.terms = {
+      { .id = ecs_id(TransformPartition), .inout = EcsIn },
+      { .id = ecs_id(TransformHierarchy), .src.id = ecs_id(TransformHierarchy) }
+    },
+    .callback = TransformPartitionSystem,
+    .multi_threaded = true
+  });
+
+  profiler_system_init(world, &(ecs_system_desc_t){
+    .entity = ecs_entity(world, {
+        .name = "TransformChangedSystem",
+        .add = ecs_ids(ecs_dependson(phase))
+    }),
+    .callback = TransformChangedSystem
+  });
+
+  // not profiled, a stamp only
+  ecs_system_init(world, &(ecs_system_desc_t){
+    .entity = ecs_entity(world, {
+        .name = "TransformLatencySystem",
+        .add = ecs_ids(ecs_dependson(phase))
+    }),
+    .callback = TransformLatencySystem
+  });
+}
+
+void transform_hierarchy_set_threads(ecs_world_t *world, int32_t threads){
+  TransformHierarchy *th = ecs_singleton_get_mut(world, TransformHierarchy);
+  if (!th) return;
+  int32_t partitions = threads > 1 ? threads : 1;
+
+  // one partition entity per thread
+  ecs_delete_with(world, ecs_id(TransformPartition));
+  if (partitions > 1) {
+    for (int32_t i = 0; i < partitions; i++) {
+      ecs_entity_t e = ecs_new(world);
+      ecs_set(world, e, TransformPartition, { .index = i });
+    }
+    ecs_set_threads(world, partitions);
+  }
+
+  th->partitionBegin = ecs_os_realloc_n(th->partitionBegin, int32_t, partitions);
+  th->partitionEnd = ecs_os_realloc_n(th->partitionEnd, int32_t, partitions);
+  th->partitionCount = partitions;
+  th->isDirty = true;
+  ecs_print(1, "transform hierarchy: %d partitions", partitions);
+}
+
+// LocalTransform3D or ChildOf added/removed, node list is out of date
+void transform_hierarchy_changed_observer(ecs_iter_t *it){
+  TransformHierarchy *th = ecs_singleton_get_mut(it->world, TransformHierarchy);
+  if (!th) return;
+  th->isDirty = true;
+}
+
+void transform_hierarchy_fini(ecs_world_t *world){
+  TransformHierarchy *th = ecs_singleton_get_mut(world, TransformHierarchy);
+  if (!th) return;
+  ecs_os_free(th->entities);
+  ecs_os_free(th->parents);
+  ecs_os_free(th->localRefs);
+  ecs_os_free(th->worldRefs);
+  ecs_os_free(th->dirty);
+  ecs_os_free(th->world);
+  ecs_os_free(th->updated);
+  ecs_os_free(th->gatherPos);
+  ecs_os_free(th->gatherRot);
+  ecs_os_free(th->gatherScale);
+  ecs_os_free(th->gatherLocal);
+  ecs_os_free(th->gatherIndex);
+  ecs_os_free(th->partitionBegin);
+  ecs_os_free(th->partitionEnd);
+  if (th->query) {
+    ecs_query_fini(th->query);
+  }
+  if (th->rootQuery) {
+    ecs_query_fini(th->rootQuery);
+  }
+  if (th->changeQuery) {
+    ecs_query_fini(th->changeQuery);
+  }
+  if (th->childQuery) {
+    ecs_query_fini(th->childQuery);
+  }
+  if (ecs_map_is_init(&th->index)) {
+    ecs_map_fini(&th->index);
+  }
+  *th = (TransformHierarchy){ .isDirty = true };
+}
+
+//===============================================
+// Transform3D compatibility
+//===============================================
+bool transform3d_get(const ecs_world_t *world, ecs_entity_t entity, Transform3D *out){
+  const LocalTransform3D *local = ecs_get(world, entity, LocalTransform3D);
+  if (!local) return false;
+  const WorldTransform3D *w = ecs_get(world, entity, WorldTransform3D);
+  out->position = local->position;
+  out->rotation = local->rotation;
+  out->scale = local->scale;
+  out->localMatrix = transform_local_matrix(local);
+  out->worldMatrix = w ? w->worldMatrix : out->localMatrix;
+  out->isDirty = false;
+  return true;
+}
+
+void transform3d_set(ecs_world_t *world, ecs_entity_t entity, const Transform3D *transform){
+  ecs_set(world, entity, LocalTransform3D, {
+    .position = transform->position,
+    .rotation = transform->rotation,
+    .scale = transform->scale
+  });
+  ecs_set(world, entity, WorldTransform3D, { .worldMatrix = transform->worldMatrix });
+}
+
+// ecs_set(world, e, Transform3D, {...}) still works, split into hot/cold components
+void transform3d_compat_observer(ecs_iter_t *it){
+  Transform3D *t = ecs_field(it, Transform3D, 0);
+  for (int i = 0; i < it->count; i++) {
+    transform3d_set(it->world, it->entities[i], &t[i]);
+    ecs_remove(it->world, it->entities[i], Transform3D);
+  }
+}
+
+void transform_hierarchy_init(ecs_world_t *world){
+  ECS_COMPONENT_DEFINE(world, Transform3D);
+  ECS_COMPONENT_DEFINE(world, LocalTransform3D);
+  ECS_COMPONENT_DEFINE(world, WorldTransform3D);
+  ECS_COMPONENT_DEFINE(world, PreviousWorldTransform3D);
+  ECS_COMPONENT_DEFINE(world, TransformHierarchy);
+  ECS_COMPONENT_DEFINE(world, TransformPartition);
+
+  // LocalTransform3D always comes with the world matrix
+  ecs_add_pair(world, ecs_id(LocalTransform3D), EcsWith, ecs_id(WorldTransform3D));
+
+  profiler_observer(world, {
+    .entity = ecs_entity(world, { .name = "transform_local_changed_observer" }),
+    .query.terms = {{ .id = ecs_id(LocalTransform3D) }},
+    .events = { EcsOnAdd, EcsOnRemove },
+    .callback = transform_hierarchy_changed_observer
+  });
+
+  profiler_observer(world, {
+    .entity = ecs_entity(world, { .name = "transform_parent_changed_observer" }),
+    .query.terms = {{ .id = ecs_pair(EcsChildOf, EcsWildcard) }},
+    .events = { EcsOnAdd, EcsOnRemove },
+    .callback = transform_hierarchy_changed_observer
+  });
+
+  profiler_observer(world, {
+    .entity = ecs_entity(world, { .name = "transform3d_compat_observer" }),
+    .query.terms = {{ .id = ecs_id(Transform3D) }},
+    .events = { EcsOnSet },
+    .callback = transform3d_compat_observer
+  });
+
+  ecs_query_t *q = query_cache_init(world, &(ecs_query_desc_t){
+    .terms = {
+      { .id = ecs_id(LocalTransform3D), .inout = EcsInOutNone }
+    },
+    .cache_kind = EcsQueryCacheAuto
+  });
+
+  // roots only, children need their parent matrix first
+  ecs_query_t *roots = query_cache_init(world, &(ecs_query_desc_t){
+    .terms = {
+      { .id = ecs_id(LocalTransform3D), .inout = EcsIn },
+      { .id = ecs_id(WorldTransform3D), .inout = EcsOut },
+      { .id = ecs_pair(EcsChildOf, EcsWildcard), .oper = EcsNot }
+    },
+    .cache_kind = EcsQueryCacheAuto
+  });
+
+  // change detection needs a cached query with an In term
+  ecs_query_t *changes = query_cache_init(world, &(ecs_query_desc_t){
+    .terms = {
+      { .id = ecs_id(LocalTransform3D), .inout = EcsIn }
+    },
+    .cache_kind = EcsQueryCacheAuto
+  });
+
+  // children, written through refs by the propagation
+  ecs_query_t *children = query_cache_init(world, &(ecs_query_desc_t){
+    .terms = {
+      { .id = ecs_id(WorldTransform3D), .inout = EcsOut },
+      { .id = ecs_id(LocalTransform3D), .inout = EcsInOutNone },
+      { .id = ecs_pair(EcsChildOf, EcsWildcard) }
+    },
+    .cache_kind = EcsQueryCacheAuto
+  });
+
+  ecs_singleton_set(world, TransformHierarchy, {
+    .isDirty = true,
+    .query = q,
+    .rootQuery = roots,
+    .changeQuery = changes,
+    .childQuery = children,
+    .partitionBegin = ecs_os_calloc_n(int32_t, 1),
+    .partitionEnd = ecs_os_calloc_n(int32_t, 1),
+    .partitionCount = 1
+  });
+}
@@ -0,0 +1,110 @@
+// frame pacer
+// absolute deadlines + hybrid sleep/spin wait, no platform headers needed
+#include <math.h>
+#include "frame_pacer.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define FRAME_PACER_PAUSE() _mm_pause()
+#else
+  #define FRAME_PACER_PAUSE() ((void)0)
+#endif
+
+// spin margin bounds, starts at 2ms and adapts to the sleep overshoot
+#define FRAME_PACER_SPIN_MIN 250000ull
+#define FRAME_PACER_SPIN_START 2000000ull
+
+void frame_pacer_init(FramePacer *p, float targetHz){
+  *p = (FramePacer){ .spinNs = FRAME_PACER_SPIN_START, .maxDelta = 0.1f };
+  frame_pacer_set_target(p, targetHz);
+  frame_pacer_stats_reset(p);
+}
+
+void frame_pacer_set_target(FramePacer *p, float targetHz){
+  p->targetNs = targetHz > 0.0f ? (uint64_t)(1e9 / targetHz) : 0;
+}
+
+static void frame_pacer_record(FramePacer *p, double frameNs){
+  p->frames++;
+  double d = frameNs - p->mean;
+  p->mean += d / p->frames;
+  p->m2 += d * (frameNs - p->mean);
+  if (frameNs < p->minNs) p->minNs = frameNs;
+  if (frameNs > p->maxNs) p->maxNs = frameNs;
+  if (p->targetNs) {
+    double target = (double)p->targetNs;
+    double error = fabs(frameNs - target);
+    if (error > p->maxErrorNs) p->maxErrorNs = error;
+    if (frameNs > target * 1.1) p->missed++;
+  }
+}
+
+float frame_pacer_begin(FramePacer *p){
+  uint64_t now = ecs_os_now();
+  if (p->frameStart == 0) {
+    p->frameStart = now;
+    p->deadline = now + p->targetNs;
+    return 0.0f;
+  }
+
+  uint64_t frameNs = now - p->frameStart;
+  frame_pacer_record(p, (double)frameNs);
+  p->frameStart = now;
+
+  // next deadline from the last one so sleep error does not add up,
+  // more than a frame late = resync instead of rushing frames
+  p->deadline += p->targetNs;
+  if (p->deadline < now) {
+    p->deadline = now + p->targetNs;
+  }
+
+  float delta = (float)((double)frameNs * 1e-9);
+  return delta > p->maxDelta ? p->maxDelta : delta;
+}
+
+void frame_pacer_wait(FramePacer *p){
+  if (p->targetNs == 0) return;
+  uint64_t now = ecs_os_now();
+  if (now >= p->deadline) return;
+
+  uint64_t remaining = p->deadline - now;
+  if (remaining > p->spinNs) {
+    uint64_t sleepNs = remaining - p->spinNs;
+    ecs_os_sleep((int32_t)(sleepNs / 1000000000ull), (int32_t)(sleepNs % 1000000000ull));
+    uint64_t after = ecs_os_now();
+    uint64_t slept = after - now;
+
+    // margin = overshoot seen now + a bit, shrinks slowly when sleeps get better
+    uint64_t overshoot = slept > sleepNs ? slept - sleepNs : 0;
+    uint64_t wanted = overshoot + FRAME_PACER_SPIN_MIN;
+    uint64_t decayed = p->spinNs - p->spinNs / 16;
+    p->spinNs = wanted > decayed ? wanted : decayed;
+    if (p->spinNs < FRAME_PACER_SPIN_MIN) p->spinNs = FRAME_PACER_SPIN_MIN;
+    if (p->spinNs > p->targetNs) p->spinNs = p->targetNs;
+  }
+
+  while (ecs_os_now() < p->deadline) {
+    FRAME_PACER_PAUSE();
+  }
+}
+
+FramePacerStats frame_pacer_stats(const FramePacer *p){
+  FramePacerStats s = { .frames = p->frames, .missed = p->missed };
+  if (p->frames == 0) return s;
+  s.avgFrameMs = (float)(p->mean * 1e-6);
+  s.minFrameMs = (float)(p->minNs * 1e-6);
+  s.maxFrameMs = (float)(p->maxNs * 1e-6);
+  s.jitterMs = p->frames > 1 ? (float)(sqrt(p->m2 / (p->frames - 1)) * 1e-6) : 0.0f;
+  s.maxErrorMs = (float)(p->maxErrorNs * 1e-6);
+  return s;
+}
+
+void frame_pacer_stats_reset(FramePacer *p){
+  p->frames = 0;
+  p->mean = 0.0;
+  p->m2 = 0.0;
+  p->minNs = 1e300;
+  p->maxNs = 0.0;
+  p->maxErrorNs = 0.0;
+  p->missed = 0;
+}
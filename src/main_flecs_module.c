@@ -14,10 +14,31 @@
 
 #include "flecs_module.h"
 #include "flecs_raylib.h"
+#include "flecs_transform.h"
+#include "flecs_culling.h"
+#include "flecs_render_stats.h"
 #include "flecs_raygui.h"
 #include "flecs_dk_console.h"
-
-#include <windows.h>
+#include "frame_pacer.h"
+#include "flecs_input.h"
+#include "flecs_startup.h"
+#include "flecs_latency.h"
+
+// worker threads for the transform hierarchy, 0 = main thread only.
+// render systems always stay on the main thread.
+#define TRANSFORM_WORKER_THREADS 0
+// task pool threads besides the main thread (culling, root transforms),
+// 0 = run inline
+#define TASK_WORKER_THREADS 3
+
+// frame pacing, 0 = uncapped. logic always steps at FIXED_STEP_HZ,
+// render runs once per frame
+#define FRAME_TARGET_HZ 60.0f
+#define FIXED_STEP_HZ 60.0f
+// logic ticks per frame at most, the rest is dropped (no spiral of death)
+#define MAX_TICKS_PER_FRAME 5
+// headless runs always dump render stats, here unless RENDER_STATS_CSV is set
+#define RENDER_STATS_CSV_HEADLESS "render_stats.csv"
 
 Vector3 MatrixGetPosition(Matrix mat){
   return (Vector3){ mat.m12, mat.m13, mat.m14 };
@@ -42,53 +63,18 @@ Vector3 MatrixGetPosition(Matrix mat){
 //   printf("\n");
 // }
 
-// Function to check if any common key is pressed [input]
-bool IsAnyKeyPressed(void){
-
-    // Check common keys (letters, numbers, space, etc.) [input]
-    int keys[] = {
-        KEY_A, KEY_B, KEY_C, KEY_D, KEY_E, KEY_F, KEY_G, KEY_H, KEY_I, KEY_J,
-        KEY_K, KEY_L, KEY_M, KEY_N, KEY_O, KEY_P, KEY_Q, KEY_R, KEY_S, KEY_T,
-        KEY_U, KEY_V, KEY_W, KEY_X, KEY_Y, KEY_Z,
-        KEY_ZERO, KEY_ONE, KEY_TWO, KEY_THREE, KEY_FOUR, KEY_FIVE, KEY_SIX,
-        KEY_SEVEN, KEY_EIGHT, KEY_NINE,
-        KEY_SPACE, KEY_ENTER, KEY_TAB
-    };
-    int keyCount = sizeof(keys) / sizeof(keys[0]);
-
-    for (int i = 0; i < keyCount; i++)
-    {
-        if (IsKeyPressed(keys[i])) return true;
-    }
-    return false;
-}
-
-// Function to check if any mouse button is pressed [input]
-bool IsAnyMouseButtonPressed(void){
-
-    // Check all defined mouse buttons [input]
-    int buttons[] = {
-        MOUSE_BUTTON_LEFT, MOUSE_BUTTON_RIGHT, MOUSE_BUTTON_MIDDLE,
-        MOUSE_BUTTON_SIDE, MOUSE_BUTTON_EXTRA, MOUSE_BUTTON_FORWARD, MOUSE_BUTTON_BACK
-    };
-    int buttonCount = sizeof(buttons) / sizeof(buttons[0]);
-
-    for (int i = 0; i < buttonCount; i++)
-    {
-        if (IsMouseButtonPressed(buttons[i])) return true;
-    }
-    return false;
-}
-
+// built in the setup phase, not a job: the scene is there on the same
+// logic tick in every run (a job runs in the render pipeline, frame timed)
 void setup_world_scene(ecs_iter_t *it){
-  RayLibContext *rl_ctx = ecs_singleton_ensure(it->world, RayLibContext);
+  ecs_world_t *world = it->world;
+  RayLibContext *rl_ctx = ecs_singleton_ensure(world, RayLibContext);
   if (!rl_ctx || !rl_ctx->isCameraValid) return;
   ecs_print(1,"set up scene");
 
   // Create floor entity
-  ecs_entity_t floor = ecs_new(it->world);
-  ecs_set_name(it->world, floor, "Floor");
-  ecs_set(it->world, floor, Transform3D, {
+  ecs_entity_t floor = ecs_new(world);
+  ecs_set_name(world, floor, "Floor");
+  ecs_set(world, floor, Transform3D, {
     .position = (Vector3){0.0f, -1.0f, 0.0f},
     .rotation = QuaternionIdentity(),
     .scale = (Vector3){20.0f, 0.5f, 20.0f},
@@ -96,20 +82,18 @@ void setup_world_scene(ecs_iter_t *it){
     .worldMatrix = MatrixIdentity(),
     .isDirty = true
   });
-  Model floorModel = LoadModelFromMesh(GenMeshCube(1.0f, 1.0f, 1.0f)); // Double extents
-  ecs_set(it->world, floor, ModelComponent, {
-    .model=floorModel,
-    .isLoaded=true
-  });
+  // all the scene cubes share one model, scale does the rest
+  rl_model_set(world, floor, asset_model_cube_async(world, 1.0f, 1.0f, 1.0f));
+  ecs_set(world, floor, MaterialComponent, { .tint=GRAY });
 
   // Create cube entity
-  // ecs_entity_t cube = ecs_new(it->world);
-  // ecs_set_name(it->world, cube, "Cube");
-  ecs_entity_t node01 = ecs_entity(it->world, {
+  // ecs_entity_t cube = ecs_new(world);
+  // ecs_set_name(world, cube, "Cube");
+  ecs_entity_t node01 = ecs_entity(world, {
     .name = "PlayerNode"
   });
 
-  ecs_set(it->world, node01, Transform3D, {
+  ecs_set(world, node01, Transform3D, {
     .position = (Vector3){0.0f, 1.0f, 0.0f},
     .rotation = QuaternionIdentity(),
     .scale = (Vector3){1.0f, 1.0f, 1.0f},
@@ -119,61 +103,57 @@ void setup_world_scene(ecs_iter_t *it){
   });
 
   // Load cube model and store in ModelComponent
-  Model cubeModel = LoadModelFromMesh(GenMeshCube(1.0f, 1.0f, 1.0f));
-  ecs_set(it->world, node01, ModelComponent, {
-    .model=cubeModel,
-    .isLoaded=true
-  });
+  rl_model_set(world, node01, asset_model_cube_async(world, 1.0f, 1.0f, 1.0f));
+  ecs_set(world, node01, MaterialComponent, { .tint=BLUE });
+  // moves with the player, drawn between logic ticks
+  ecs_set(world, node01, PreviousWorldTransform3D, { .worldMatrix=MatrixIdentity() });
 
   // child
-  // ecs_entity_t node2 = ecs_new(it->world);
-  // ecs_set_name(it->world, node2, "NodeChild");
-  ecs_entity_t node2 = ecs_entity(it->world, {
+  // ecs_entity_t node2 = ecs_new(world);
+  // ecs_set_name(world, node2, "NodeChild");
+  ecs_entity_t node2 = ecs_entity(world, {
     .name = "Camera3DNode",
     // .parent = cube
   });
-  ecs_set(it->world, node2, Transform3D, {
+  ecs_set(world, node2, Transform3D, {
       .position = (Vector3){0.0f, 1.0f, 0.0f},
       .rotation = QuaternionIdentity(),
       .scale = (Vector3){0.5f, 0.5f, 0.5f},
       .localMatrix = MatrixIdentity(),
       .worldMatrix = MatrixIdentity()
   });
-  ecs_add_pair(it->world, node2, EcsChildOf, node01);
-
-  Model cubeModel02 = LoadModelFromMesh(GenMeshCube(1.0f, 1.0f, 1.0f));
-  ecs_set(it->world, node2, ModelComponent, {
-    //&cube
-    .model=cubeModel02,
-    // .model=cubeModel,
-    .isLoaded=true
-  });
+  ecs_add_pair(world, node2, EcsChildOf, node01);
 
-  // ecs_entity_t node3 = ecs_entity(it->world, {
+  rl_model_set(world, node2, asset_model_cube_async(world, 1.0f, 1.0f, 1.0f));
+  ecs_set(world, node2, MaterialComponent, { .tint=BLUE });
+  // moves with the player, drawn between logic ticks
+  ecs_set(world, node2, PreviousWorldTransform3D, { .worldMatrix=MatrixIdentity() });
+
+  // ecs_entity_t node3 = ecs_entity(world, {
   //   .name = "NodeChild3",
   //   //.parent = cube
   // });
-  // ecs_set(it->world, node3, Transform3D, {
+  // ecs_set(world, node3, Transform3D, {
   //     .position = (Vector3){2.0f, 0.0f, 0.0f},
   //     .rotation = QuaternionIdentity(),
   //     .scale = (Vector3){0.5f, 0.5f, 0.5f},
   //     .localMatrix = MatrixIdentity(),
   //     .worldMatrix = MatrixIdentity()
   // });
-  // // ecs_add_pair(it->world, node2, EcsChildOf, cube);
+  // // ecs_add_pair(world, node2, EcsChildOf, cube);
 
   // Model cubeModel03 = LoadModelFromMesh(GenMeshCube(1.0f, 1.0f, 1.0f));
-  // ecs_set(it->world, node3, ModelComponent, {
+  // ecs_set(world, node3, ModelComponent, {
   //   //&cube
   //   .model=cubeModel03,
   //   .isLoaded=true
   // });
 
 
-  ecs_entity_t node3 = ecs_entity(it->world, {
+  ecs_entity_t node3 = ecs_entity(world, {
     .name = "Block",
   });
-  ecs_set(it->world, node3, Transform3D, {
+  ecs_set(world, node3, Transform3D, {
       .position = (Vector3){0.0f, 0.0f, 5.0f},
       .rotation = QuaternionIdentity(),
       .scale = (Vector3){1.0f, 1.0f, 1.0f},
@@ -181,19 +161,19 @@ void setup_world_scene(ecs_iter_t *it){
       .worldMatrix = MatrixIdentity(),
       .isDirty = true
   });
-  // ecs_add_pair(it->world, node2, EcsChildOf, cube);
+  // ecs_add_pair(world, node2, EcsChildOf, cube);
 
-  Model cubeModel04 = LoadModelFromMesh(GenMeshCube(1.0f, 1.0f, 1.0f));
-  ecs_set(it->world, node3, ModelComponent, {
-    .model=cubeModel04,
-    .isLoaded=true
-  });
+  rl_model_set(world, node3, asset_model_cube_async(world, 1.0f, 1.0f, 1.0f));
+  ecs_set(world, node3, MaterialComponent, { .tint=BLUE });
 
-  ecs_set(it->world, node3, CubeComponent, {0});
+  ecs_set(world, node3, CubeComponent, {0});
 
   rl_ctx->isLoaded=true;
 }
 
+// WorldTransform3D + CubeComponent, player collision
+static QueryHandle cubeCollisionQuery;
+
 void user_input_system(ecs_iter_t *it){
   RayLibContext *rl_ctx = ecs_singleton_ensure(it->world, RayLibContext);
   if(!rl_ctx) return;
@@ -204,18 +184,29 @@ void user_input_system(ecs_iter_t *it){
   CameraContext_T *c_ctx = ecs_singleton_ensure(it->world, CameraContext_T);
   if(!c_ctx) return;
 
+  // nothing moved, ecs_iter_skip keeps the LocalTransform3D table unchanged
+  // so the transform propagation can skip it
   DKConsoleContext *dkc_ctx = ecs_singleton_ensure(it->world, DKConsoleContext);
-  if(!dkc_ctx || !dkc_ctx->console || dkc_ctx->console->is_open==true) return;
+  if(!dkc_ctx || !dkc_ctx->console || dkc_ctx->console->is_open==true) {
+    ecs_iter_skip(it);
+    return;
+  }
 
-  if(c_ctx->currentMode != F_CAMERA_PLAYER) return;
+  if(c_ctx->currentMode != F_CAMERA_PLAYER) {
+    ecs_iter_skip(it);
+    return;
+  }
+
+  // this tick's actions (rl_input_system), replays the same as live
+  const InputActions *act = &pi_ctx->actions;
 
-  Transform3D *t = ecs_field(it, Transform3D, 0);
+  LocalTransform3D *t = ecs_field(it, LocalTransform3D, 0);
   // float dt = GetFrameTime(); it->delta_time;
   // float dt = it->delta_time;
 
-  Vector2 mouseDelta = GetMouseDelta();  // Mouse movement [input]
-  pi_ctx->yaw -= mouseDelta.x * pi_ctx->mouseSensitivity;
-  pi_ctx->pitch -= mouseDelta.y * pi_ctx->mouseSensitivity;
+  // Mouse movement [input]
+  pi_ctx->yaw -= act->axes[INPUT_AXIS_LOOK_X] * pi_ctx->mouseSensitivity;
+  pi_ctx->pitch -= act->axes[INPUT_AXIS_LOOK_Y] * pi_ctx->mouseSensitivity;
   pi_ctx->pitch = Clamp(pi_ctx->pitch, -PI/2.0f + 0.1f, PI/2.0f - 0.1f);  // Limit pitch [raymath]
 
   // Update camera target based on yaw and pitch [raymath]
@@ -252,7 +243,8 @@ void user_input_system(ecs_iter_t *it){
       cosf(pi_ctx->yaw)               // Z: Forward/backward (negative cos for -Z forward)
     };
 
-    float dt = GetFrameTime();
+    // logic tick step, GetFrameTime is the displayed frame (0 headless)
+    float dt = it->delta_time;
     float moveTime = pi_ctx->moveSpeed * dt;
 
     forward = Vector3Normalize(forward); // Ensure unit length
@@ -260,41 +252,38 @@ void user_input_system(ecs_iter_t *it){
     Vector3 right = Vector3CrossProduct(forward, rl_ctx->camera.up);
     Vector3 originPos = t[player_idx].position;
 
-    if (IsKeyDown(KEY_W)){
+    if (pi_ctx->Up){
       // ecs_print(1,"forward");
       t[player_idx].position = Vector3Add(t[player_idx].position, Vector3Scale(forward, moveTime));
-      t[player_idx].isDirty = true;
+      wasModified = true;
     }
-    if (IsKeyDown(KEY_S)) {
+    if (pi_ctx->Down) {
       t[player_idx].position = Vector3Subtract(t[player_idx].position, Vector3Scale(forward, moveTime));
-      t[player_idx].isDirty = true;
+      wasModified = true;
     }
-    if (IsKeyDown(KEY_A)) {
+    if (pi_ctx->Left) {
       t[player_idx].position = Vector3Subtract(t[player_idx].position, Vector3Scale(right, moveTime));
-      t[player_idx].isDirty = true;
+      wasModified = true;
     }
-    if (IsKeyDown(KEY_D)) {
+    if (pi_ctx->Right) {
       t[player_idx].position = Vector3Add(t[player_idx].position, Vector3Scale(right, moveTime));
-      t[player_idx].isDirty = true;
+      wasModified = true;
     }
-    if (IsKeyPressed(KEY_R)) {
+    if (act->pressed & INPUT_ACTION_BIT(ACTION_RESET)) {
       t[player_idx].position = (Vector3){0.0f, 0.0f, 0.0f};
       t[player_idx].rotation = QuaternionIdentity();
       t[player_idx].scale = (Vector3){1.0f, 1.0f, 1.0f};
       wasModified = true;
     }
-    if (wasModified) {
-      //update matrix 3d
-      t[player_idx].isDirty = true;
-      // printf("Marked %s as dirty\n", name);
+    if (!wasModified) {
+      // no key, world matrix stays the same
+      ecs_iter_skip(it);
+      return;
     }
 
-    ecs_query_t *q = ecs_query(it->world, {
-      .terms = {
-        { .id = ecs_id(Transform3D) },
-        { .id = ecs_id(CubeComponent) },
-      }
-    });
+    // cached, declared in main
+    ecs_query_t *q = query_cache_get(it->world, cubeCollisionQuery);
+    if (!q) return;
 
     ecs_iter_t s_it = ecs_query_iter(it->world, q);
 
@@ -303,7 +292,7 @@ void user_input_system(ecs_iter_t *it){
 
     while (ecs_query_next(&s_it)) {
       //ecs_print(1,"blocks %d", s_it.count);
-      Transform3D *t_3d = ecs_field(&s_it, Transform3D, 0);
+      WorldTransform3D *t_3d = ecs_field(&s_it, WorldTransform3D, 0);
       CubeComponent *s_com = ecs_field(&s_it, CubeComponent, 1);
       Vector3 b_pos = MatrixGetPosition(t_3d->worldMatrix);
       // ecs_print(1,"x:%0.2f, y:%0.2f, z:%0.2f", b_pos.x,b_pos.y,b_pos.z);
@@ -341,6 +330,8 @@ void user_input_system(ecs_iter_t *it){
 
 
 
+  } else {
+    ecs_iter_skip(it);
   }
 }
 
@@ -362,7 +353,9 @@ void user_capture_input_system(ecs_iter_t *it){
   // ecs_print(1,"delta %d", it->delta_time);
   // ecs_print(1,"delta_system_time %d", it->delta_system_time);
 
-  if (IsKeyPressed(KEY_TAB)){
+  const InputActions *act = &pi_ctx->actions;
+
+  if (pi_ctx->tabPressed){
     c_ctx->currentMode = (FCameraMode)((c_ctx->currentMode + 1) % 3); // Cycle through modes
     switch (c_ctx->currentMode){
       case F_CAMERA_FREE:
@@ -377,19 +370,23 @@ void user_capture_input_system(ecs_iter_t *it){
     }
   }
 
-  int key = GetKeyPressed();
-  // ecs_print(1,"key press: %d", key);
+  // no GetKeyPressed here, input_pump owns the raylib key queue
 
   // if(!pi_ctx->isCaptureMouse && ( (key > 0) || IsMouseButtonPressed(MOUSE_BUTTON_LEFT) )) {
-  if(!pi_ctx->isCaptureMouse && ( IsAnyKeyPressed() || IsAnyMouseButtonPressed() )) {
-    HideCursor();
-    DisableCursor();  // Locks mouse to window
+  // capture state follows the input, the cursor only exists with a window
+  if(!pi_ctx->isCaptureMouse && (act->pressed & INPUT_ACTION_BIT(ACTION_CAPTURE_MOUSE))) {
+    if (!rl_ctx->isHeadless) {
+      HideCursor();
+      DisableCursor();  // Locks mouse to window
+    }
     pi_ctx->isCaptureMouse = true;
   }
 
-  if (pi_ctx->isCaptureMouse && IsKeyPressed(KEY_ESCAPE)){
-    EnableCursor();  // Release mouse
-    ShowCursor();
+  if (pi_ctx->isCaptureMouse && (act->pressed & INPUT_ACTION_BIT(ACTION_RELEASE_MOUSE))){
+    if (!rl_ctx->isHeadless) {
+      EnableCursor();  // Release mouse
+      ShowCursor();
+    }
     pi_ctx->isCaptureMouse = false;
   }
 
@@ -459,7 +456,7 @@ void camera_first_person_mode_input_system(ecs_iter_t *it){
 
   if(c_ctx->currentMode != F_CAMERA_PLAYER) return;
 
-  Transform3D *t = ecs_field(it, Transform3D, 0);
+  WorldTransform3D *t = ecs_field(it, WorldTransform3D, 0);
 
   for (int i = 0; i < it->count; i++) {
     const char *name = ecs_get_name(it->world, it->entities[i]);
@@ -489,11 +486,13 @@ void camera_free_mode_input_system(ecs_iter_t *it){
 
   if(c_ctx->currentMode != F_CAMERA_FREE) return;
 
+  const InputActions *act = &pi_ctx->actions;
+
   if (pi_ctx->isCaptureMouse){
 
-    Vector2 mouseDelta = GetMouseDelta();  // Mouse movement [input]
-    pi_ctx->yaw -= mouseDelta.x * pi_ctx->mouseSensitivity;
-    pi_ctx->pitch -= mouseDelta.y * pi_ctx->mouseSensitivity;
+    // Mouse movement [input]
+    pi_ctx->yaw -= act->axes[INPUT_AXIS_LOOK_X] * pi_ctx->mouseSensitivity;
+    pi_ctx->pitch -= act->axes[INPUT_AXIS_LOOK_Y] * pi_ctx->mouseSensitivity;
     pi_ctx->pitch = Clamp(pi_ctx->pitch, -PI/2.0f + 0.1f, PI/2.0f - 0.1f);  // Limit pitch [raymath]
 
     // Update camera target based on yaw and pitch [raymath]
@@ -512,39 +511,29 @@ void camera_free_mode_input_system(ecs_iter_t *it){
   //ecs_print(1,"delta_time ");
   // ecs_print(1,"delta %d", it->delta_time);
 
-  float dt = GetFrameTime();
+  float dt = it->delta_time;
   float moveTime = pi_ctx->moveSpeed * dt;
 
-  // Forward/Backward (W/S)
-  if (IsKeyDown(KEY_W))  // Move forward [input]
-    rl_ctx->camera.position = Vector3Add(rl_ctx->camera.position, Vector3Scale(forward, moveTime));  // [raymath]
-  if (IsKeyDown(KEY_S))  // Move backward [input]
-    rl_ctx->camera.position = Vector3Add(rl_ctx->camera.position, Vector3Scale(forward, -moveTime)); // [raymath]
-
-  // Left/Right (A/D)
-  if (IsKeyDown(KEY_A))  // Move left [input]
-    rl_ctx->camera.position = Vector3Add(rl_ctx->camera.position, Vector3Scale(right, -moveTime));  // [raymath]
-  if (IsKeyDown(KEY_D))  // Move right [input]
-    rl_ctx->camera.position = Vector3Add(rl_ctx->camera.position, Vector3Scale(right, moveTime));   // [raymath]
-
-  // Up/Down (Space/Shift)
-  if (IsKeyDown(KEY_SPACE))  // Move up [input]
-    rl_ctx->camera.position = Vector3Add(rl_ctx->camera.position, Vector3Scale(up, moveTime));      // [raymath]
-  if (IsKeyDown(KEY_LEFT_SHIFT))  // Move down [input]
-    rl_ctx->camera.position = Vector3Add(rl_ctx->camera.position, Vector3Scale(up, -moveTime));     // [raymath]
+  // Forward/Backward, Left/Right, Up/Down axes, -1..1 [input]
+  rl_ctx->camera.position = Vector3Add(rl_ctx->camera.position, Vector3Scale(forward, act->axes[INPUT_AXIS_MOVE_Y] * moveTime));  // [raymath]
+  rl_ctx->camera.position = Vector3Add(rl_ctx->camera.position, Vector3Scale(right, act->axes[INPUT_AXIS_MOVE_X] * moveTime));    // [raymath]
+  rl_ctx->camera.position = Vector3Add(rl_ctx->camera.position, Vector3Scale(up, act->axes[INPUT_AXIS_MOVE_Z] * moveTime));       // [raymath]
 
   // Update camera target after movement
   rl_ctx->camera.target = Vector3Add(rl_ctx->camera.position, forward);
 }
 
 void rl_hud_render2d_system(ecs_iter_t *it){
+  const RayLibContext *rl_ctx = ecs_singleton_get(it->world, RayLibContext);
+  if (!rl_ctx || rl_ctx->isHeadless) return;
+
   PlayerInput_T *pi_ctx = ecs_singleton_ensure(it->world, PlayerInput_T);
   if (!pi_ctx) return;
 
   CameraContext_T *c_ctx = ecs_singleton_ensure(it->world, CameraContext_T);
   if(!c_ctx) return;
 
-  Transform3D *t = ecs_field(it, Transform3D, 0);
+  LocalTransform3D *t = ecs_field(it, LocalTransform3D, 0);
   // ecs_print(1,"hud");
 
   // DrawText(TextFormat("Entities Rendered: %d", it->count), 10, 10+20, 20, DARKGRAY);
@@ -587,6 +576,11 @@ void rl_hud_render2d_system(ecs_iter_t *it){
   }
 
 
+  const CullingContext *cull = ecs_singleton_get(it->world, CullingContext);
+  if (cull) {
+    DrawText(TextFormat("Visible: %d Culled: %d", cull->visible, cull->culled), 10, 70, 20, DARKGRAY);
+  }
+
   // DrawText(TextFormat("Toggled mode to: %s\n", pi_ctx->isMovementMode ? "Movement" : "Rotation"), 10, 30, 20, DARKGRAY);
 }
 
@@ -596,14 +590,38 @@ int main() {
 
   // Initialize Flecs world
   ecs_world_t *world = ecs_init();
+  // time to first frame counts from here, each init step is marked
+  startup_begin();
 
   bool isRunning = false;
   flecs_module_init(world);
+  startup_mark("flecs_module_init");
+  flecs_module_set_task_workers(world, TASK_WORKER_THREADS);
+  startup_mark("task workers");
   flecs_raylib_module_init(world);
+  transform_hierarchy_set_threads(world, TRANSFORM_WORKER_THREADS);
+  startup_mark("flecs_raylib_module_init");
   flecs_raygui_module_init(world);
+  startup_mark("flecs_raygui_module_init");
   flecs_dk_console_module_init(world);
+  startup_mark("flecs_dk_console_module_init");
+  // RENDER_STATS_CSV=path dumps one row of render stats per frame
+  const char *statsCsv = getenv("RENDER_STATS_CSV");
+  if (!statsCsv && ecs_singleton_get(world, RayLibContext)->isHeadless) {
+    statsCsv = RENDER_STATS_CSV_HEADLESS;
+  }
+  if (statsCsv) {
+    render_stats_csv_open(ecs_singleton_get_mut(world, RenderStats), statsCsv);
+  }
+  // queries of the systems below, built once
+  cubeCollisionQuery = query_cache(world, "cube_collision", {
+    .terms = {
+      { .id = ecs_id(WorldTransform3D), .inout = EcsIn },
+      { .id = ecs_id(CubeComponent), .inout = EcsIn },
+    }
+  });
   // set up entity
-  ecs_system_init(world, &(ecs_system_desc_t){
+  profiler_system_init(world, &(ecs_system_desc_t){
     .entity = ecs_entity(world, { 
         .name = "setup_world_scene", 
         .add = ecs_ids(ecs_dependson(GlobalPhases.OnSetupWorldPhase)) 
@@ -611,93 +629,110 @@ int main() {
     .callback = setup_world_scene
   });
   // input capture and release mouse
-  ecs_system_init(world, &(ecs_system_desc_t){
+  profiler_system_init(world, &(ecs_system_desc_t){
     .entity = ecs_entity(world, { .name = "user_capture_input_system", .add = ecs_ids(ecs_dependson(GlobalPhases.LogicUpdatePhase)) }),
     .callback = user_capture_input_system
   });
   // camera 3d freee mode
-  ecs_system_init(world, &(ecs_system_desc_t){
+  profiler_system_init(world, &(ecs_system_desc_t){
     .entity = ecs_entity(world, { .name = "camera_free_mode_input_system", .add = ecs_ids(ecs_dependson(GlobalPhases.LogicUpdatePhase)) }),
     .query.terms = {
-      { .id = ecs_id(Transform3D), .src.id = EcsSelf },
+      { .id = ecs_id(LocalTransform3D), .src.id = EcsSelf, .inout = EcsIn },
     },
     .callback = camera_free_mode_input_system
   });
   // camera3d first person mode
-  ecs_system_init(world, &(ecs_system_desc_t){
+  profiler_system_init(world, &(ecs_system_desc_t){
     .entity = ecs_entity(world, { .name = "camera_first_person_mode_input_system", .add = ecs_ids(ecs_dependson(GlobalPhases.LogicUpdatePhase)) }),
     .query.terms = {
-      { .id = ecs_id(Transform3D), .src.id = EcsSelf },
+      { .id = ecs_id(WorldTransform3D), .src.id = EcsSelf, .inout = EcsIn },
     },
     .callback = camera_first_person_mode_input_system
   });
   // player input keys
-  ecs_system_init(world, &(ecs_system_desc_t){
+  profiler_system_init(world, &(ecs_system_desc_t){
     .entity = ecs_entity(world, { .name = "user_input_system", .add = ecs_ids(ecs_dependson(GlobalPhases.LogicUpdatePhase)) }),
     .query.terms = {
-      { .id = ecs_id(Transform3D), .src.id = EcsSelf },
+      { .id = ecs_id(LocalTransform3D), .src.id = EcsSelf },
     },
     .callback = user_input_system
   });
   // draw 2d
-  ecs_system_init(world, &(ecs_system_desc_t){
+  profiler_system_init(world, &(ecs_system_desc_t){
     .entity = ecs_entity(world, { .name = "rl_hud_render2d_system", .add = ecs_ids(ecs_dependson(GlobalPhases.Render2D1Phase)) }),
     .query.terms = {
-        { ecs_id(Transform3D)  }//,
+        { .id = ecs_id(LocalTransform3D), .inout = EcsIn }//,
         // { .id = ecs_id(Transform3D), .src.id = EcsSelf }//,
         //{ .id = ecs_id(ModelComponent), .src.id = EcsSelf }
     },
     .callback = rl_hud_render2d_system
   });
-
-  // Initialize time variables
-  clock_t last_time = clock();
-  float delta_time = 0.0f;
-  const float target_frame_time = 1.0f / 60.0f; // Target 60 FPS (16.66ms)
-  const float fixed_time_step = 1.0f / 60.0f; // Fixed step for consistent updates
-  float accumulated_time = 0.0f;
+  // after every other system so its sampler runs last in the frame
+  flecs_profiler_module_init(world);
+  flecs_trace_module_init(world);
+  // last, its markers close each setup phase
+  flecs_startup_module_init(world);
+  startup_mark("main systems");
+
+  // RL_HEADLESS=1 (or RayLibContext.isHeadless), no window, one logic tick
+  // per frame at the fixed step, uncapped, so runs are reproducible
+  bool isHeadless = ecs_singleton_get(world, RayLibContext)->isHeadless;
+
+  // wall clock pacing, monotonic ns clock
+  FramePacer pacer;
+  frame_pacer_init(&pacer, isHeadless ? 0.0f : FRAME_TARGET_HZ);
+  ecs_singleton_set(world, SimulationClock, { .fixedStep = 1.0f / FIXED_STEP_HZ });
   
   while (!isRunning) {
     
     RayLibContext *rl_ctx = ecs_singleton_ensure(world, RayLibContext);
     if(!rl_ctx) return;
-    // float dt = GetFrameTime();
-    // ecs_print(1,"dt %.8f", dt);
-    // ecs_progress(world, dt);
-    
-    // Calculate delta_time in seconds
-    clock_t current_time = clock();
-    delta_time = (float)(current_time - last_time) / CLOCKS_PER_SEC;
-    last_time = current_time;
-
-    // Cap delta_time to avoid large jumps
-    if (delta_time > 0.1f) delta_time = 0.1f;
-
-    // Accumulate time for fixed time step
-    accumulated_time += delta_time;
-
-    // Process fixed time steps
-    while (accumulated_time >= fixed_time_step) {
-      ecs_progress(world, fixed_time_step); // Use fixed time step for consistency
-      // ecs_print(1, "loop delta_time %.8f", fixed_time_step);
-      accumulated_time -= fixed_time_step;
-    }
 
-    // Frame rate control: Sleep to approximate 60 FPS
-    clock_t frame_end_time = clock();
-    float frame_time = (float)(frame_end_time - current_time) / CLOCKS_PER_SEC;
-    float sleep_time = target_frame_time - frame_time;
-    if (sleep_time > 0) {
-        Sleep((DWORD)(sleep_time * 1000.0f)); // Convert seconds to milliseconds
+    // fixed step logic pipeline for the wall time since the last frame,
+    // then the render pipeline once
+    float frameDelta = frame_pacer_begin(&pacer);
+    if (isHeadless) frameDelta = 1.0f / FIXED_STEP_HZ;
+    flecs_module_frame(world, frameDelta, MAX_TICKS_PER_FRAME);
+    // first frame that drew, before the pacer wait
+    if (!startup_is_done() && ecs_get_world_info(world)->frame_count_total > 0) {
+      startup_first_frame();
     }
 
+    // sleep then spin until the frame deadline
+    frame_pacer_wait(&pacer);
+
     // close loop
     isRunning = rl_ctx->shouldQuit;
   }
 
+  FramePacerStats ps = frame_pacer_stats(&pacer);
+  printf("frames %d avg %.3f ms min %.3f max %.3f jitter %.3f ms max error %.3f ms missed %d\n",
+    ps.frames, ps.avgFrameMs, ps.minFrameMs, ps.maxFrameMs, ps.jitterMs, ps.maxErrorMs, ps.missed);
+  // input -> present with a window, the simulation part headless
+  latency_print();
+  // PROFILER_DUMP=path writes the per system histograms on exit
+  const char *profDump = getenv("PROFILER_DUMP");
+  if (profDump) {
+    profiler_print();
+    profiler_dump(profDump);
+  }
+  // TRACE_CAPTURE=path traced the whole run, chrome trace json
+  const char *traceCapture = getenv("TRACE_CAPTURE");
+  if (traceCapture) {
+    trace_print();
+    trace_dump(traceCapture);
+  }
+  if (isHeadless) {
+    render_stats_print(ecs_singleton_get(world, RenderStats));
+    profiler_print();
+    task_pool_print(flecs_module_task_pool(world));
+    asset_load_print(ecs_singleton_get(world, AssetRegistry));
+    query_cache_print(ecs_singleton_get(world, QueryCache));
+    input_print(ecs_singleton_get(world, InputState));
+  }
   printf("clean up\n");
   // clean up
-  CloseWindow();
+  if (!isHeadless) CloseWindow();
   // UnloadModel(cubeModel); // Unload the model
   // clean model
   // UnloadModel(floorModel);
@@ -0,0 +1,297 @@
+// sorted render queue + instanced batching
+// mesh and material pointers get small per frame ids on add, the radix sort
+// on build keeps the whole frame linear in the number of instances.
+#include <string.h>
+#include "render_batch.h"
+#include "rlgl.h"
+
+// Same attributes/uniforms as the raylib default shader plus a per instance matrix
+static const char *render_batch_vs =
+  "#version 330\n"
+  "in vec3 vertexPosition;\n"
+  "in vec2 vertexTexCoord;\n"
+  "in vec4 vertexColor;\n"
+  "in mat4 instanceTransform;\n"
+  "uniform mat4 mvp;\n"
+  "out vec2 fragTexCoord;\n"
+  "out vec4 fragColor;\n"
+  "void main() {\n"
+  "  fragTexCoord = vertexTexCoord;\n"
+  "  fragColor = vertexColor;\n"
+  "  gl_Position = mvp*instanceTransform*vec4(vertexPosition, 1.0);\n"
+  "}\n";
+
+static const char *render_batch_fs =
+  "#version 330\n"
+  "in vec2 fragTexCoord;\n"
+  "in vec4 fragColor;\n"
+  "uniform sampler2D texture0;\n"
+  "uniform vec4 colDiffuse;\n"
+  "out vec4 finalColor;\n"
+  "void main() {\n"
+  "  finalColor = texture(texture0, fragTexCoord)*colDiffuse*fragColor;\n"
+  "}\n";
+
+void render_batch_init(RenderBatcher *b){
+  *b = (RenderBatcher){ .lastMesh = -1, .lastMaterial = -1 };
+  ecs_map_init(&b->meshIndex, NULL);
+  ecs_map_init(&b->materialIndex, NULL);
+}
+
+void render_batch_fini(RenderBatcher *b){
+  ecs_os_free(b->groups);
+  ecs_os_free(b->meshes);
+  ecs_os_free(b->materials);
+  ecs_os_free(b->items);
+  ecs_os_free(b->itemsTmp);
+  ecs_os_free(b->matrices);
+  ecs_os_free(b->transforms);
+  if (ecs_map_is_init(&b->meshIndex)) {
+    ecs_map_fini(&b->meshIndex);
+  }
+  if (ecs_map_is_init(&b->materialIndex)) {
+    ecs_map_fini(&b->materialIndex);
+  }
+  *b = (RenderBatcher){ .lastMesh = -1, .lastMaterial = -1 };
+}
+
+void render_batch_begin(RenderBatcher *b){
+  b->groupCount = 0;
+  b->meshCount = 0;
+  b->materialCount = 0;
+  b->count = 0;
+  b->lastMesh = -1;
+  b->lastMaterial = -1;
+  ecs_map_clear(&b->meshIndex);
+  ecs_map_clear(&b->materialIndex);
+}
+
+static uint64_t render_batch_hash_mesh(const Mesh *mesh){
+  return (uint64_t)(uintptr_t)mesh * 0x9E3779B97F4A7C15ull;
+}
+
+static uint64_t render_batch_hash_material(const Material *material, Color tint){
+  uint64_t k = (uint64_t)(uintptr_t)material * 0xC2B2AE3D27D4EB4Full;
+  k ^= ((uint64_t)tint.r << 24 | (uint64_t)tint.g << 16 | (uint64_t)tint.b << 8 | tint.a) * 0x165667B19E3779F9ull;
+  return k;
+}
+
+static bool render_batch_material_is(const RenderMaterialSlot *m, const Material *material, Color tint){
+  return m->material == material &&
+    m->tint.r == tint.r && m->tint.g == tint.g && m->tint.b == tint.b && m->tint.a == tint.a;
+}
+
+static int32_t render_batch_mesh_id(RenderBatcher *b, const Mesh *mesh){
+  if (b->lastMesh >= 0 && b->meshes[b->lastMesh] == mesh) {
+    return b->lastMesh;
+  }
+
+  // hash collisions probe the next key
+  uint64_t key = render_batch_hash_mesh(mesh);
+  ecs_map_val_t *v;
+  while ((v = ecs_map_get(&b->meshIndex, key)) != NULL) {
+    if (b->meshes[*v] == mesh) {
+      b->lastMesh = (int32_t)*v;
+      return b->lastMesh;
+    }
+    key++;
+  }
+
+  ecs_assert(b->meshCount < (1 << RENDER_KEY_MESH_BITS), ECS_OUT_OF_RANGE, "too many meshes in one frame");
+  if (b->meshCount == b->meshCapacity) {
+    b->meshCapacity = b->meshCapacity ? b->meshCapacity * 2 : 16;
+    b->meshes = ecs_os_realloc_n(b->meshes, const Mesh*, b->meshCapacity);
+  }
+  int32_t id = b->meshCount++;
+  b->meshes[id] = mesh;
+  ecs_map_insert(&b->meshIndex, key, (ecs_map_val_t)id);
+  b->lastMesh = id;
+  return id;
+}
+
+static int32_t render_batch_material_id(RenderBatcher *b, const Material *material, Color tint){
+  if (b->lastMaterial >= 0 && render_batch_material_is(&b->materials[b->lastMaterial], material, tint)) {
+    return b->lastMaterial;
+  }
+
+  uint64_t key = render_batch_hash_material(material, tint);
+  ecs_map_val_t *v;
+  while ((v = ecs_map_get(&b->materialIndex, key)) != NULL) {
+    if (render_batch_material_is(&b->materials[*v], material, tint)) {
+      b->lastMaterial = (int32_t)*v;
+      return b->lastMaterial;
+    }
+    key++;
+  }
+
+  ecs_assert(b->materialCount < (1 << RENDER_KEY_MATERIAL_BITS), ECS_OUT_OF_RANGE, "too many materials in one frame");
+  if (b->materialCount == b->materialCapacity) {
+    b->materialCapacity = b->materialCapacity ? b->materialCapacity * 2 : 16;
+    b->materials = ecs_os_realloc_n(b->materials, RenderMaterialSlot, b->materialCapacity);
+  }
+  int32_t id = b->materialCount++;
+  b->materials[id] = (RenderMaterialSlot){ .material = material, .tint = tint };
+  ecs_map_insert(&b->materialIndex, key, (ecs_map_val_t)id);
+  b->lastMaterial = id;
+  return id;
+}
+
+void render_batch_add(RenderBatcher *b, const Mesh *mesh, const Material *material, Color tint,
+  uint8_t layer, float depth, const Matrix *transform){
+  if (b->count == b->capacity) {
+    b->capacity = b->capacity ? b->capacity * 2 : 256;
+    b->items = ecs_os_realloc_n(b->items, RenderQueueItem, b->capacity);
+    b->itemsTmp = ecs_os_realloc_n(b->itemsTmp, RenderQueueItem, b->capacity);
+    b->matrices = ecs_os_realloc_n(b->matrices, Matrix, b->capacity);
+    b->transforms = ecs_os_realloc_n(b->transforms, Matrix, b->capacity);
+  }
+
+  // NaN fails both compares and ends up at 0
+  float d = depth < 1.0f ? (depth > 0.0f ? depth : 0.0f) : 1.0f;
+  uint64_t depthBits = (uint64_t)(d * (float)((1u << RENDER_KEY_DEPTH_BITS) - 1));
+  uint64_t key = (uint64_t)(layer & ((1u << RENDER_KEY_LAYER_BITS) - 1)) << RENDER_KEY_LAYER_SHIFT;
+  key |= (uint64_t)render_batch_material_id(b, material, tint) << RENDER_KEY_MATERIAL_SHIFT;
+  key |= (uint64_t)render_batch_mesh_id(b, mesh) << RENDER_KEY_MESH_SHIFT;
+  key |= depthBits;
+
+  b->items[b->count] = (RenderQueueItem){ .key = key, .index = b->count };
+  b->matrices[b->count] = *transform;
+  b->count++;
+}
+
+// LSD radix sort, 8 bits per pass. All histograms come from one read of the
+// keys, passes where every key has the same byte are skipped.
+static void render_batch_sort(RenderBatcher *b){
+  int32_t n = b->count;
+  if (n < 2) return;
+
+  int32_t histogram[8][256];
+  memset(histogram, 0, sizeof(histogram));
+  for (int32_t i = 0; i < n; i++) {
+    uint64_t key = b->items[i].key;
+    for (int pass = 0; pass < 8; pass++) {
+      histogram[pass][(key >> (pass * 8)) & 0xFF]++;
+    }
+  }
+
+  RenderQueueItem *src = b->items;
+  RenderQueueItem *dst = b->itemsTmp;
+  for (int pass = 0; pass < 8; pass++) {
+    int32_t *h = histogram[pass];
+    int shift = pass * 8;
+    if (h[(src[0].key >> shift) & 0xFF] == n) continue;
+
+    int32_t offset = 0;
+    for (int i = 0; i < 256; i++) {
+      int32_t c = h[i];
+      h[i] = offset;
+      offset += c;
+    }
+    for (int32_t i = 0; i < n; i++) {
+      dst[h[(src[i].key >> shift) & 0xFF]++] = src[i];
+    }
+    RenderQueueItem *tmp = src;
+    src = dst;
+    dst = tmp;
+  }
+  // keep the sorted queue in items
+  b->items = src;
+  b->itemsTmp = dst;
+}
+
+void render_batch_build(RenderBatcher *b){
+  render_batch_sort(b);
+
+  b->groupCount = 0;
+  uint64_t depthMask = (1ull << RENDER_KEY_DEPTH_BITS) - 1;
+  for (int32_t i = 0; i < b->count; i++) {
+    const RenderQueueItem *item = &b->items[i];
+    uint64_t key = item->key & ~depthMask;
+    if (b->groupCount == 0 || b->groups[b->groupCount - 1].key != key) {
+      if (b->groupCount == b->groupCapacity) {
+        b->groupCapacity = b->groupCapacity ? b->groupCapacity * 2 : 16;
+        b->groups = ecs_os_realloc_n(b->groups, RenderBatchGroup, b->groupCapacity);
+      }
+      const RenderMaterialSlot *m = &b->materials[(key >> RENDER_KEY_MATERIAL_SHIFT) & ((1u << RENDER_KEY_MATERIAL_BITS) - 1)];
+      b->groups[b->groupCount++] = (RenderBatchGroup){
+        .key = key,
+        .mesh = b->meshes[(key >> RENDER_KEY_MESH_SHIFT) & ((1u << RENDER_KEY_MESH_BITS) - 1)],
+        .material = m->material,
+        .tint = m->tint,
+        .start = i
+      };
+    }
+    b->groups[b->groupCount - 1].count++;
+    b->transforms[i] = b->matrices[item->index];
+  }
+
+  // stats, cpu side so headless runs get them too
+  b->vertices = 0;
+  b->triangles = 0;
+  b->materialChanges = 0;
+  for (int32_t g = 0; g < b->groupCount; g++) {
+    const RenderBatchGroup *group = &b->groups[g];
+    b->vertices += group->mesh->vertexCount * group->count;
+    b->triangles += group->mesh->triangleCount * group->count;
+    uint64_t material = group->key >> RENDER_KEY_MATERIAL_SHIFT;
+    if (g == 0 || (b->groups[g - 1].key >> RENDER_KEY_MATERIAL_SHIFT) != material) {
+      b->materialChanges++;
+    }
+  }
+}
+
+static void render_batch_load_shader(RenderBatcher *b){
+  b->isShaderLoaded = true;
+  b->shader = LoadShaderFromMemory(render_batch_vs, render_batch_fs);
+  b->isInstancing = IsShaderValid(b->shader) && b->shader.id != rlGetShaderIdDefault();
+  if (!b->isInstancing) {
+    TraceLog(LOG_WARNING, "render batch: instancing shader failed, using one draw per instance");
+    return;
+  }
+  b->shader.locs[SHADER_LOC_MATRIX_MVP] = GetShaderLocation(b->shader, "mvp");
+  b->shader.locs[SHADER_LOC_MATRIX_MODEL] = GetShaderLocationAttrib(b->shader, "instanceTransform");
+}
+
+void render_batch_submit(RenderBatcher *b, bool wires){
+  if (!b->isShaderLoaded) {
+    render_batch_load_shader(b);
+  }
+  b->drawCalls = 0;
+  b->instances = b->count;
+  if (wires) rlEnableWireMode();
+  for (int32_t g = 0; g < b->groupCount; g++) {
+    const RenderBatchGroup *group = &b->groups[g];
+    Material material = *group->material;
+    // tint goes through colDiffuse like DrawModel, restore after the draw
+    Color color = material.maps[MATERIAL_MAP_DIFFUSE].color;
+    material.maps[MATERIAL_MAP_DIFFUSE].color = ColorTint(color, group->tint);
+    if (b->isInstancing && group->count > 1) {
+      material.shader = b->shader;
+      DrawMeshInstanced(*group->mesh, material, &b->transforms[group->start], group->count);
+      b->drawCalls++;
+    } else {
+      for (int32_t i = 0; i < group->count; i++) {
+        DrawMesh(*group->mesh, material, b->transforms[group->start + i]);
+      }
+      b->drawCalls += group->count;
+    }
+    material.maps[MATERIAL_MAP_DIFFUSE].color = color;
+  }
+  if (wires) rlDisableWireMode();
+}
+
+void render_batch_count(RenderBatcher *b){
+  b->drawCalls = 0;
+  b->instances = b->count;
+  for (int32_t g = 0; g < b->groupCount; g++) {
+    b->drawCalls += b->groups[g].count > 1 ? 1 : b->groups[g].count;
+  }
+}
+
+void render_batch_unload(RenderBatcher *b){
+  if (b->isShaderLoaded && b->isInstancing) {
+    UnloadShader(b->shader);
+  }
+  b->isShaderLoaded = false;
+  b->isInstancing = false;
+}
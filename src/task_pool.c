@@ -0,0 +1,363 @@
+// work stealing task pool
+// per thread deques behind a small lock each (the flecs os api has no CAS),
+// owner works LIFO at the tail, thieves take FIFO from the head
+#include <string.h>
+#include "task_pool.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define TASK_POOL_PAUSE() _mm_pause()
+#else
+  #define TASK_POOL_PAUSE() ((void)0)
+#endif
+
+// chunks per thread in a parallel for, room for stealing to even out the work
+#define TASK_POOL_CHUNKS_PER_THREAD 4
+#define TASK_POOL_LOCAL_CHUNKS 64
+
+// counters are only written through ecs_os_ainc/adec, read with an acquire
+// load so what the writer did before the decrement is visible after it.
+// A deque count is written under the deque lock with a release store, the
+// lock free "empty?" check before the lock reads it with the acquire load.
+#if defined(_MSC_VER)
+  #include <intrin.h>
+  static int32_t task_pool_load(const int32_t *v){
+    return (int32_t)_InterlockedCompareExchange((volatile long *)v, 0, 0);
+  }
+  static void task_pool_store(int32_t *v, int32_t value){
+    _InterlockedExchange((volatile long *)v, value);
+  }
+#else
+  static int32_t task_pool_load(const int32_t *v){
+    return __atomic_load_n(v, __ATOMIC_ACQUIRE);
+  }
+  static void task_pool_store(int32_t *v, int32_t value){
+    __atomic_store_n(v, value, __ATOMIC_RELEASE);
+  }
+#endif
+
+static void task_deque_init(TaskDeque *d){
+  *d = (TaskDeque){ .lock = ecs_os_mutex_new() };
+}
+
+static void task_deque_fini(TaskDeque *d){
+  ecs_os_free(d->tasks);
+  ecs_os_mutex_free(d->lock);
+  *d = (TaskDeque){0};
+}
+
+static void task_deque_push(TaskDeque *d, const Task *task){
+  ecs_os_mutex_lock(d->lock);
+  if (d->count == d->capacity) {
+    // unwrap into the new buffer, head goes back to 0
+    int32_t capacity = d->capacity ? d->capacity * 2 : 64;
+    Task *tasks = ecs_os_malloc_n(Task, capacity);
+    for (int32_t i = 0; i < d->count; i++) {
+      tasks[i] = d->tasks[(d->head + i) % d->capacity];
+    }
+    ecs_os_free(d->tasks);
+    d->tasks = tasks;
+    d->head = 0;
+    d->capacity = capacity;
+  }
+  d->tasks[(d->head + d->count) % d->capacity] = *task;
+  task_pool_store(&d->count, d->count + 1);
+  ecs_os_mutex_unlock(d->lock);
+}
+
+static bool task_deque_pop_tail(TaskDeque *d, Task *out){
+  if (task_pool_load(&d->count) == 0) return false;
+  bool found = false;
+  ecs_os_mutex_lock(d->lock);
+  if (d->count > 0) {
+    task_pool_store(&d->count, d->count - 1);
+    *out = d->tasks[(d->head + d->count) % d->capacity];
+    found = true;
+  }
+  ecs_os_mutex_unlock(d->lock);
+  return found;
+}
+
+static bool task_deque_pop_head(TaskDeque *d, Task *out){
+  if (task_pool_load(&d->count) == 0) return false;
+  bool found = false;
+  ecs_os_mutex_lock(d->lock);
+  if (d->count > 0) {
+    *out = d->tasks[d->head];
+    d->head = (d->head + 1) % d->capacity;
+    task_pool_store(&d->count, d->count - 1);
+    found = true;
+  }
+  ecs_os_mutex_unlock(d->lock);
+  return found;
+}
+
+int32_t task_pool_worker_index(const TaskPool *p){
+  if (!p) return 0;
+  ecs_os_thread_id_t self = ecs_os_thread_self();
+  for (int32_t i = 0; i <= p->workerCount; i++) {
+    if (p->threadIds[i] == self) return i;
+  }
+  return -1;
+}
+
+bool task_pool_is_main_thread(const TaskPool *p){
+  return !p || task_pool_worker_index(p) == 0;
+}
+
+int32_t task_pool_threads(const TaskPool *p){
+  return p ? p->workerCount + 1 : 1;
+}
+
+// own deque, then main thread work, then steal from the others
+static bool task_pool_take(TaskPool *p, int32_t self, Task *out){
+  int32_t slots = p->workerCount + 1;
+  if (self >= 0 && task_deque_pop_tail(&p->deques[self], out)) {
+    ecs_os_adec(&p->queued);
+    return true;
+  }
+  if (self == 0 && task_deque_pop_head(&p->mainQueue, out)) {
+    return true;
+  }
+  int32_t start = self >= 0 ? self : 0;
+  for (int32_t k = 1; k <= slots; k++) {
+    int32_t victim = (start + k) % slots;
+    if (victim == self) continue;
+    if (task_deque_pop_head(&p->deques[victim], out)) {
+      ecs_os_adec(&p->queued);
+      if (self >= 0) p->stats[self].stolen++;
+      return true;
+    }
+  }
+  return false;
+}
+
+static void task_pool_execute(TaskPool *p, int32_t self, const Task *task){
+  task->callback(task->ctx, self >= 0 ? self : 0);
+  if (self >= 0) p->stats[self].executed++;
+  if (task->group) ecs_os_adec(&task->group->pending);
+}
+
+static void task_pool_wake(TaskPool *p, int32_t count){
+  ecs_os_mutex_lock(p->sleepLock);
+  if (count > 1) {
+    ecs_os_cond_broadcast(p->wake);
+  } else {
+    ecs_os_cond_signal(p->wake);
+  }
+  ecs_os_mutex_unlock(p->sleepLock);
+}
+
+static void *task_pool_worker(void *arg){
+  TaskWorkerStart *start = arg;
+  TaskPool *p = start->pool;
+  int32_t self = start->worker;
+  p->threadIds[self] = ecs_os_thread_self();
+  ecs_os_ainc(&p->started);
+
+  for (;;) {
+    Task task;
+    if (task_pool_take(p, self, &task)) {
+      task_pool_execute(p, self, &task);
+      continue;
+    }
+    // queued is raised before the pusher takes sleepLock, checked under it here,
+    // so a push can not slip between the check and the wait
+    ecs_os_mutex_lock(p->sleepLock);
+    if (p->isStopping) {
+      ecs_os_mutex_unlock(p->sleepLock);
+      break;
+    }
+    if (task_pool_load(&p->queued) == 0) {
+      p->stats[self].sleeps++;
+      ecs_os_cond_wait(p->wake, p->sleepLock);
+    }
+    ecs_os_mutex_unlock(p->sleepLock);
+  }
+  return NULL;
+}
+
+void task_pool_init(TaskPool *p, int32_t workers){
+  if (workers < 0) workers = 0;
+  if (workers > TASK_POOL_MAX_WORKERS) workers = TASK_POOL_MAX_WORKERS;
+  int32_t slots = workers + 1;
+  *p = (TaskPool){ .workerCount = workers };
+
+  p->deques = ecs_os_calloc_n(TaskDeque, slots);
+  for (int32_t i = 0; i < slots; i++) {
+    task_deque_init(&p->deques[i]);
+  }
+  task_deque_init(&p->mainQueue);
+  p->stats = ecs_os_calloc_n(TaskWorkerStats, slots);
+  p->threadIds = ecs_os_calloc_n(ecs_os_thread_id_t, slots);
+  p->threadIds[0] = ecs_os_thread_self();
+  p->sleepLock = ecs_os_mutex_new();
+  p->wake = ecs_os_cond_new();
+
+  if (workers > 0) {
+    p->starts = ecs_os_calloc_n(TaskWorkerStart, workers);
+    p->threads = ecs_os_calloc_n(ecs_os_thread_t, workers);
+    for (int32_t i = 0; i < workers; i++) {
+      p->starts[i] = (TaskWorkerStart){ .pool = p, .worker = i + 1 };
+      p->threads[i] = ecs_os_thread_new(task_pool_worker, &p->starts[i]);
+    }
+    // task_pool_worker_index needs every thread id
+    while (task_pool_load(&p->started) < workers) {
+      TASK_POOL_PAUSE();
+    }
+  }
+  ecs_print(1, "task pool: %d workers + main thread", workers);
+}
+
+void task_pool_fini(TaskPool *p){
+  ecs_os_mutex_lock(p->sleepLock);
+  p->isStopping = true;
+  ecs_os_cond_broadcast(p->wake);
+  ecs_os_mutex_unlock(p->sleepLock);
+  for (int32_t i = 0; i < p->workerCount; i++) {
+    ecs_os_thread_join(p->threads[i]);
+  }
+  // nobody waits on a group that never finishes
+  Task task;
+  for (int32_t i = 0; i <= p->workerCount; i++) {
+    while (task_deque_pop_head(&p->deques[i], &task)) task_pool_execute(p, 0, &task);
+  }
+  while (task_deque_pop_head(&p->mainQueue, &task)) task_pool_execute(p, 0, &task);
+
+  for (int32_t i = 0; i <= p->workerCount; i++) {
+    task_deque_fini(&p->deques[i]);
+  }
+  task_deque_fini(&p->mainQueue);
+  ecs_os_free(p->deques);
+  ecs_os_free(p->stats);
+  ecs_os_free(p->threadIds);
+  ecs_os_free(p->starts);
+  ecs_os_free(p->threads);
+  ecs_os_cond_free(p->wake);
+  ecs_os_mutex_free(p->sleepLock);
+  *p = (TaskPool){0};
+}
+
+void task_pool_spawn(TaskPool *p, TaskGroup *group, TaskCallback callback, void *ctx){
+  if (!p || p->workerCount == 0) {
+    callback(ctx, 0);
+    return;
+  }
+  if (group) ecs_os_ainc(&group->pending);
+  int32_t self = task_pool_worker_index(p);
+  Task task = { .callback = callback, .ctx = ctx, .group = group };
+  // counted before it is visible so a thief never takes queued below zero
+  ecs_os_ainc(&p->queued);
+  task_deque_push(&p->deques[self >= 0 ? self : 0], &task);
+  task_pool_wake(p, 1);
+}
+
+void task_pool_spawn_main(TaskPool *p, TaskGroup *group, TaskCallback callback, void *ctx){
+  if (!p || p->workerCount == 0) {
+    callback(ctx, 0);
+    return;
+  }
+  // not counted in queued, workers have nothing to wake up for
+  if (group) ecs_os_ainc(&group->pending);
+  Task task = { .callback = callback, .ctx = ctx, .group = group };
+  task_deque_push(&p->mainQueue, &task);
+}
+
+// a worker waiting on main thread tasks needs the main thread to wait or
+// call task_pool_run_main, otherwise it spins until it does
+void task_pool_wait(TaskPool *p, TaskGroup *group){
+  if (!p || !group) return;
+  int32_t self = task_pool_worker_index(p);
+  while (task_pool_load(&group->pending) > 0) {
+    Task task;
+    if (task_pool_take(p, self, &task)) {
+      task_pool_execute(p, self, &task);
+    } else {
+      TASK_POOL_PAUSE();
+    }
+  }
+}
+
+bool task_group_done(const TaskGroup *group){
+  return !group || task_pool_load(&group->pending) <= 0;
+}
+
+int32_t task_pool_run_main(TaskPool *p){
+  if (!p || !task_pool_is_main_thread(p)) return 0;
+  int32_t ran = 0;
+  Task task;
+  while (task_deque_pop_head(&p->mainQueue, &task)) {
+    task_pool_execute(p, 0, &task);
+    ran++;
+  }
+  return ran;
+}
+
+typedef struct {
+  TaskRangeCallback callback;
+  void *ctx;
+  int32_t begin;
+  int32_t end;
+} TaskRangeChunk;
+
+static void task_pool_range_task(void *ctx, int32_t worker){
+  const TaskRangeChunk *chunk = ctx;
+  chunk->callback(chunk->ctx, chunk->begin, chunk->end, worker);
+}
+
+void task_pool_parallel_for(TaskPool *p, int32_t count, int32_t grain, TaskRangeCallback callback, void *ctx){
+  if (count <= 0) return;
+  if (grain < 1) grain = 1;
+  int32_t self = task_pool_worker_index(p);
+  int32_t slot = self >= 0 ? self : 0;
+  int32_t threads = task_pool_threads(p);
+  int32_t chunks = (count + grain - 1) / grain;
+  if (chunks > threads * TASK_POOL_CHUNKS_PER_THREAD) chunks = threads * TASK_POOL_CHUNKS_PER_THREAD;
+  // threads the pool does not know (flecs workers) run it whole, their slot
+  // would collide with the main thread in per worker results
+  if (threads <= 1 || chunks <= 1 || self < 0) {
+    callback(ctx, 0, count, slot);
+    return;
+  }
+
+  TaskRangeChunk local[TASK_POOL_LOCAL_CHUNKS];
+  TaskRangeChunk *chunk = chunks <= TASK_POOL_LOCAL_CHUNKS ? local : ecs_os_malloc_n(TaskRangeChunk, chunks);
+  for (int32_t c = 0; c < chunks; c++) {
+    chunk[c] = (TaskRangeChunk){
+      .callback = callback,
+      .ctx = ctx,
+      .begin = (int32_t)((int64_t)count * c / chunks),
+      .end = (int32_t)((int64_t)count * (c + 1) / chunks)
+    };
+  }
+
+  // chunk 0 runs here, the rest is up for grabs
+  TaskGroup group = { .pending = chunks - 1 };
+  for (int32_t c = 1; c < chunks; c++) {
+    Task task = { .callback = task_pool_range_task, .ctx = &chunk[c], .group = &group };
+    ecs_os_ainc(&p->queued);
+    task_deque_push(&p->deques[slot], &task);
+  }
+  task_pool_wake(p, chunks - 1);
+
+  callback(ctx, chunk[0].begin, chunk[0].end, slot);
+  p->stats[slot].executed++;
+  task_pool_wait(p, &group);
+
+  if (chunk != local) ecs_os_free(chunk);
+}
+
+void task_pool_stats_reset(TaskPool *p){
+  if (!p) return;
+  memset(p->stats, 0, sizeof(TaskWorkerStats) * (size_t)(p->workerCount + 1));
+}
+
+void task_pool_print(const TaskPool *p){
+  if (!p) return;
+  ecs_print(1, "task pool, %d workers + main", p->workerCount);
+  for (int32_t i = 0; i <= p->workerCount; i++) {
+    const TaskWorkerStats *s = &p->stats[i];
+    ecs_print(1, "  %s %2d executed %lld stolen %lld sleeps %lld", i == 0 ? "main  " : "worker", i,
+      (long long)s->executed, (long long)s->stolen, (long long)s->sleeps);
+  }
+}
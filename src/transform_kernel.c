@@ -0,0 +1,272 @@
+// batch TRS to matrix kernels (SSE2 / AVX2 / scalar)
+// see transform_kernel.h, math follows raymath QuaternionToMatrix/MatrixMultiply
+// with the zero terms folded away. "+ 0.0f" turns -0 into +0, raymath can
+// still give -0 there, so zeros match up to sign. flecs_transform_bench checks
+// the rest against raymath.
+#include "transform_kernel.h"
+
+#if defined(__AVX2__)
+  #include <immintrin.h>
+  #define TRANSFORM_KERNEL_AVX2
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define TRANSFORM_KERNEL_SSE
+#endif
+
+// Element i of a strided array
+#define KERNEL_AT(base, stride, i) ((const float *)((const char *)(base) + (stride) * (size_t)(i)))
+
+void transform_compose_scalar(Vector3 position, Quaternion q, Vector3 scale, Matrix *out){
+  float a2 = q.x*q.x;
+  float b2 = q.y*q.y;
+  float c2 = q.z*q.z;
+  float ac = q.x*q.z;
+  float ab = q.x*q.y;
+  float bc = q.y*q.z;
+  float ad = q.w*q.x;
+  float bd = q.w*q.y;
+  float cd = q.w*q.z;
+
+  out->m0 = scale.x*(1.0f - 2.0f*(b2 + c2)) + 0.0f;
+  out->m1 = scale.x*(2.0f*(ab + cd)) + 0.0f;
+  out->m2 = scale.x*(2.0f*(ac - bd)) + 0.0f;
+  out->m3 = 0.0f;
+  out->m4 = scale.y*(2.0f*(ab - cd)) + 0.0f;
+  out->m5 = scale.y*(1.0f - 2.0f*(a2 + c2)) + 0.0f;
+  out->m6 = scale.y*(2.0f*(bc + ad)) + 0.0f;
+  out->m7 = 0.0f;
+  out->m8 = scale.z*(2.0f*(ac + bd)) + 0.0f;
+  out->m9 = scale.z*(2.0f*(bc - ad)) + 0.0f;
+  out->m10 = scale.z*(1.0f - 2.0f*(a2 + b2)) + 0.0f;
+  out->m11 = 0.0f;
+  out->m12 = position.x;
+  out->m13 = position.y;
+  out->m14 = position.z;
+  out->m15 = 1.0f;
+}
+
+#if defined(TRANSFORM_KERNEL_SSE)
+// Quaternions of 4 entities as x, y, z, w lanes
+static inline void kernel_load_quat4(const Quaternion *rotations, size_t stride, int32_t i,
+  __m128 *x, __m128 *y, __m128 *z, __m128 *w){
+  __m128 q0 = _mm_loadu_ps(KERNEL_AT(rotations, stride, i));
+  __m128 q1 = _mm_loadu_ps(KERNEL_AT(rotations, stride, i + 1));
+  __m128 q2 = _mm_loadu_ps(KERNEL_AT(rotations, stride, i + 2));
+  __m128 q3 = _mm_loadu_ps(KERNEL_AT(rotations, stride, i + 3));
+  _MM_TRANSPOSE4_PS(q0, q1, q2, q3);
+  *x = q0; *y = q1; *z = q2; *w = q3;
+}
+
+// One component of a Vector3 for 4 entities
+static inline __m128 kernel_load_vec4(const Vector3 *v, size_t stride, int32_t i, int c){
+  return _mm_setr_ps(
+    KERNEL_AT(v, stride, i)[c], KERNEL_AT(v, stride, i + 1)[c],
+    KERNEL_AT(v, stride, i + 2)[c], KERNEL_AT(v, stride, i + 3)[c]);
+}
+
+// Lanes hold one matrix element for 4 entities, transpose back to 4 matrices.
+// raylib Matrix memory rows are (m0 m4 m8 m12) (m1 m5 m9 m13) (m2 m6 m10 m14) (m3 m7 m11 m15)
+static inline void kernel_store4(Matrix *out,
+  __m128 m0, __m128 m1, __m128 m2, __m128 m4, __m128 m5, __m128 m6,
+  __m128 m8, __m128 m9, __m128 m10, __m128 px, __m128 py, __m128 pz){
+  __m128 row3 = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+  _MM_TRANSPOSE4_PS(m0, m4, m8, px);
+  _MM_TRANSPOSE4_PS(m1, m5, m9, py);
+  _MM_TRANSPOSE4_PS(m2, m6, m10, pz);
+  __m128 r0[4] = { m0, m4, m8, px };
+  __m128 r1[4] = { m1, m5, m9, py };
+  __m128 r2[4] = { m2, m6, m10, pz };
+  for (int e = 0; e < 4; e++) {
+    float *f = (float *)&out[e];
+    _mm_storeu_ps(f, r0[e]);
+    _mm_storeu_ps(f + 4, r1[e]);
+    _mm_storeu_ps(f + 8, r2[e]);
+    _mm_storeu_ps(f + 12, row3);
+  }
+}
+
+static void kernel_compose_sse4(
+  const Vector3 *positions, size_t ps, const Quaternion *rotations, size_t rs,
+  const Vector3 *scales, size_t ss, Matrix *out, int32_t i){
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 two = _mm_set1_ps(2.0f);
+  const __m128 zero = _mm_setzero_ps();
+  __m128 x, y, z, w;
+  kernel_load_quat4(rotations, rs, i, &x, &y, &z, &w);
+
+  __m128 a2 = _mm_mul_ps(x, x);
+  __m128 b2 = _mm_mul_ps(y, y);
+  __m128 c2 = _mm_mul_ps(z, z);
+  __m128 ac = _mm_mul_ps(x, z);
+  __m128 ab = _mm_mul_ps(x, y);
+  __m128 bc = _mm_mul_ps(y, z);
+  __m128 ad = _mm_mul_ps(w, x);
+  __m128 bd = _mm_mul_ps(w, y);
+  __m128 cd = _mm_mul_ps(w, z);
+
+  __m128 sx = kernel_load_vec4(scales, ss, i, 0);
+  __m128 sy = kernel_load_vec4(scales, ss, i, 1);
+  __m128 sz = kernel_load_vec4(scales, ss, i, 2);
+
+  __m128 m0 = _mm_add_ps(_mm_mul_ps(sx, _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(b2, c2)))), zero);
+  __m128 m1 = _mm_add_ps(_mm_mul_ps(sx, _mm_mul_ps(two, _mm_add_ps(ab, cd))), zero);
+  __m128 m2 = _mm_add_ps(_mm_mul_ps(sx, _mm_mul_ps(two, _mm_sub_ps(ac, bd))), zero);
+  __m128 m4 = _mm_add_ps(_mm_mul_ps(sy, _mm_mul_ps(two, _mm_sub_ps(ab, cd))), zero);
+  __m128 m5 = _mm_add_ps(_mm_mul_ps(sy, _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(a2, c2)))), zero);
+  __m128 m6 = _mm_add_ps(_mm_mul_ps(sy, _mm_mul_ps(two, _mm_add_ps(bc, ad))), zero);
+  __m128 m8 = _mm_add_ps(_mm_mul_ps(sz, _mm_mul_ps(two, _mm_add_ps(ac, bd))), zero);
+  __m128 m9 = _mm_add_ps(_mm_mul_ps(sz, _mm_mul_ps(two, _mm_sub_ps(bc, ad))), zero);
+  __m128 m10 = _mm_add_ps(_mm_mul_ps(sz, _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(a2, b2)))), zero);
+
+  kernel_store4(&out[i], m0, m1, m2, m4, m5, m6, m8, m9, m10,
+    kernel_load_vec4(positions, ps, i, 0),
+    kernel_load_vec4(positions, ps, i, 1),
+    kernel_load_vec4(positions, ps, i, 2));
+}
+#endif
+
+#if defined(TRANSFORM_KERNEL_AVX2)
+static inline __m256 kernel_join(__m128 lo, __m128 hi){
+  return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+}
+
+static void kernel_compose_avx8(
+  const Vector3 *positions, size_t ps, const Quaternion *rotations, size_t rs,
+  const Vector3 *scales, size_t ss, Matrix *out, int32_t i){
+  const __m256 one = _mm256_set1_ps(1.0f);
+  const __m256 two = _mm256_set1_ps(2.0f);
+  const __m256 zero = _mm256_setzero_ps();
+  __m128 xl, yl, zl, wl, xh, yh, zh, wh;
+  kernel_load_quat4(rotations, rs, i, &xl, &yl, &zl, &wl);
+  kernel_load_quat4(rotations, rs, i + 4, &xh, &yh, &zh, &wh);
+  __m256 x = kernel_join(xl, xh);
+  __m256 y = kernel_join(yl, yh);
+  __m256 z = kernel_join(zl, zh);
+  __m256 w = kernel_join(wl, wh);
+
+  __m256 a2 = _mm256_mul_ps(x, x);
+  __m256 b2 = _mm256_mul_ps(y, y);
+  __m256 c2 = _mm256_mul_ps(z, z);
+  __m256 ac = _mm256_mul_ps(x, z);
+  __m256 ab = _mm256_mul_ps(x, y);
+  __m256 bc = _mm256_mul_ps(y, z);
+  __m256 ad = _mm256_mul_ps(w, x);
+  __m256 bd = _mm256_mul_ps(w, y);
+  __m256 cd = _mm256_mul_ps(w, z);
+
+  __m256 sx = kernel_join(kernel_load_vec4(scales, ss, i, 0), kernel_load_vec4(scales, ss, i + 4, 0));
+  __m256 sy = kernel_join(kernel_load_vec4(scales, ss, i, 1), kernel_load_vec4(scales, ss, i + 4, 1));
+  __m256 sz = kernel_join(kernel_load_vec4(scales, ss, i, 2), kernel_load_vec4(scales, ss, i + 4, 2));
+
+  __m256 m[9];
+  m[0] = _mm256_add_ps(_mm256_mul_ps(sx, _mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(b2, c2)))), zero);
+  m[1] = _mm256_add_ps(_mm256_mul_ps(sx, _mm256_mul_ps(two, _mm256_add_ps(ab, cd))), zero);
+  m[2] = _mm256_add_ps(_mm256_mul_ps(sx, _mm256_mul_ps(two, _mm256_sub_ps(ac, bd))), zero);
+  m[3] = _mm256_add_ps(_mm256_mul_ps(sy, _mm256_mul_ps(two, _mm256_sub_ps(ab, cd))), zero);
+  m[4] = _mm256_add_ps(_mm256_mul_ps(sy, _mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(a2, c2)))), zero);
+  m[5] = _mm256_add_ps(_mm256_mul_ps(sy, _mm256_mul_ps(two, _mm256_add_ps(bc, ad))), zero);
+  m[6] = _mm256_add_ps(_mm256_mul_ps(sz, _mm256_mul_ps(two, _mm256_add_ps(ac, bd))), zero);
+  m[7] = _mm256_add_ps(_mm256_mul_ps(sz, _mm256_mul_ps(two, _mm256_sub_ps(bc, ad))), zero);
+  m[8] = _mm256_add_ps(_mm256_mul_ps(sz, _mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(a2, b2)))), zero);
+
+  // store each half with the SSE transpose
+  for (int h = 0; h < 2; h++) {
+    __m128 e[9];
+    for (int k = 0; k < 9; k++) {
+      e[k] = h ? _mm256_extractf128_ps(m[k], 1) : _mm256_castps256_ps128(m[k]);
+    }
+    int32_t j = i + h * 4;
+    kernel_store4(&out[j], e[0], e[1], e[2], e[3], e[4], e[5], e[6], e[7], e[8],
+      kernel_load_vec4(positions, ps, j, 0),
+      kernel_load_vec4(positions, ps, j, 1),
+      kernel_load_vec4(positions, ps, j, 2));
+  }
+}
+#endif
+
+void transform_compose_batch_strided(
+  const Vector3 *positions, size_t positionStride,
+  const Quaternion *rotations, size_t rotationStride,
+  const Vector3 *scales, size_t scaleStride,
+  Matrix *out, int32_t count){
+  int32_t i = 0;
+#if defined(TRANSFORM_KERNEL_AVX2)
+  for (; i + 8 <= count; i += 8) {
+    kernel_compose_avx8(positions, positionStride, rotations, rotationStride,
+      scales, scaleStride, out, i);
+  }
+#endif
+#if defined(TRANSFORM_KERNEL_SSE)
+  for (; i + 4 <= count; i += 4) {
+    kernel_compose_sse4(positions, positionStride, rotations, rotationStride,
+      scales, scaleStride, out, i);
+  }
+#endif
+  for (; i < count; i++) {
+    const float *p = KERNEL_AT(positions, positionStride, i);
+    const float *q = KERNEL_AT(rotations, rotationStride, i);
+    const float *s = KERNEL_AT(scales, scaleStride, i);
+    transform_compose_scalar(
+      (Vector3){ p[0], p[1], p[2] },
+      (Quaternion){ q[0], q[1], q[2], q[3] },
+      (Vector3){ s[0], s[1], s[2] },
+      &out[i]);
+  }
+}
+
+void transform_compose_batch(const Vector3 *positions, const Quaternion *rotations,
+  const Vector3 *scales, Matrix *out, int32_t count){
+  transform_compose_batch_strided(
+    positions, sizeof(Vector3),
+    rotations, sizeof(Quaternion),
+    scales, sizeof(Vector3),
+    out, count);
+}
+
+// Row r of the result is sum_k right[r][k] * left row k (memory rows),
+// summed in the same order as raymath MatrixMultiply
+void transform_matrix_multiply(const Matrix *left, const Matrix *right, Matrix *out){
+  const float *l = (const float *)left;
+  const float *r = (const float *)right;
+#if defined(TRANSFORM_KERNEL_SSE)
+  __m128 l0 = _mm_loadu_ps(l);
+  __m128 l1 = _mm_loadu_ps(l + 4);
+  __m128 l2 = _mm_loadu_ps(l + 8);
+  __m128 l3 = _mm_loadu_ps(l + 12);
+  __m128 rows[4];
+  for (int row = 0; row < 4; row++) {
+    const float *rr = r + row * 4;
+    __m128 v = _mm_mul_ps(_mm_set1_ps(rr[0]), l0);
+    v = _mm_add_ps(v, _mm_mul_ps(_mm_set1_ps(rr[1]), l1));
+    v = _mm_add_ps(v, _mm_mul_ps(_mm_set1_ps(rr[2]), l2));
+    v = _mm_add_ps(v, _mm_mul_ps(_mm_set1_ps(rr[3]), l3));
+    rows[row] = v;
+  }
+  float *o = (float *)out;
+  for (int row = 0; row < 4; row++) {
+    _mm_storeu_ps(o + row * 4, rows[row]);
+  }
+#else
+  float result[16];
+  for (int row = 0; row < 4; row++) {
+    for (int c = 0; c < 4; c++) {
+      result[row * 4 + c] = r[row * 4 + 0] * l[c] + r[row * 4 + 1] * l[4 + c] +
+        r[row * 4 + 2] * l[8 + c] + r[row * 4 + 3] * l[12 + c];
+    }
+  }
+  float *o = (float *)out;
+  for (int k = 0; k < 16; k++) o[k] = result[k];
+#endif
+}
+
+const char *transform_kernel_name(void){
+#if defined(TRANSFORM_KERNEL_AVX2)
+  return "avx2";
+#elif defined(TRANSFORM_KERNEL_SSE)
+  return "sse2";
+#else
+  return "scalar";
+#endif
+}